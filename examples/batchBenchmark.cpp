@@ -0,0 +1,179 @@
+#include "VL53L1XBatchBus.hpp"
+#include "VL53L1XT.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// Number of simulated sensors on the bus
+static constexpr uint8_t SENSOR_COUNT = 8;
+
+// Address of the first sensor, the others follow
+static constexpr uint8_t FIRST_ADDRESS = 0x30;
+
+// Data-ready polls of a sensor before it has a new sample
+static constexpr uint32_t POLLS_PER_SAMPLE = 4;
+
+// Samples collected from each sensor by each method
+static constexpr uint32_t SAMPLES = 10000;
+
+/**
+ * Stand-in for i2c-dev: a set of simulated sensors answering I2C_RDWR transfers, counting the transfers
+ * (syscalls on real hardware), messages and bytes on the bus.
+ *
+ * A sensor has a new sample after every POLLS_PER_SAMPLE reads of its status, until its interrupt is cleared.
+ * Optionally rejects reads other than the last message, like i2c-bcm2835 (Raspberry Pi).
+ */
+struct FakeTransfer {
+	struct Sensor {
+		std::vector<uint8_t> registers = std::vector<uint8_t>(0x10000);
+		uint32_t polls = 0;
+		uint16_t distance = 0;
+	};
+
+	static Sensor sensors[SENSOR_COUNT];
+
+	static uint64_t transfers;
+
+	static uint64_t messages;
+
+	static uint64_t bytes;
+
+	static bool readLastOnly;
+
+	static int transfer(int, i2c_msg* transferMessages, uint32_t count) noexcept {
+		transfers++;
+		for (uint32_t i = 0; readLastOnly && i + 1 < count; i++) {
+			if (transferMessages[i].flags & I2C_M_RD) {
+				return -EOPNOTSUPP;
+			}
+		}
+		uint16_t registerAddress = 0;
+		for (uint32_t i = 0; i < count; i++) {
+			const i2c_msg& message = transferMessages[i];
+			if (message.addr < FIRST_ADDRESS || message.addr >= FIRST_ADDRESS + SENSOR_COUNT) {
+				return -ENXIO;
+			}
+			Sensor& sensor = sensors[message.addr - FIRST_ADDRESS];
+			messages++;
+			bytes += message.len;
+			if (message.flags & I2C_M_RD) {
+				for (uint16_t j = 0; j < message.len; j++) {
+					message.buf[j] = readRegister(sensor, static_cast<uint16_t>(registerAddress + j));
+				}
+				continue;
+			}
+			registerAddress = static_cast<uint16_t>((message.buf[0] << 8) | message.buf[1]);
+			for (uint16_t j = 2; j < message.len; j++) {
+				writeRegister(sensor, static_cast<uint16_t>(registerAddress + j - 2), message.buf[j]);
+			}
+		}
+		return 0;
+	}
+
+	static uint8_t readRegister(Sensor& sensor, uint16_t registerAddress) {
+		switch (registerAddress) {
+			case 0x0031: // GPIO__TIO_HV_STATUS, active high (GPIO_HV_MUX__CTRL is 0)
+				return ++sensor.polls >= POLLS_PER_SAMPLE ? 1 : 0;
+			case 0x0096: // RESULT__FINAL_CROSSTALK_CORRECTED_RANGE_MM_SD0
+				return static_cast<uint8_t>(sensor.distance >> 8);
+			case 0x0097:
+				return static_cast<uint8_t>(sensor.distance);
+			default:
+				return sensor.registers[registerAddress];
+		}
+	}
+
+	static void writeRegister(Sensor& sensor, uint16_t registerAddress, uint8_t value) {
+		sensor.registers[registerAddress] = value;
+		if (registerAddress == 0x0086 && (value & 0x01)) { // SYSTEM__INTERRUPT_CLEAR
+			sensor.polls = 0;
+			sensor.distance = static_cast<uint16_t>((sensor.distance + 7) % 4000);
+		}
+	}
+
+	static void resetCounters() {
+		transfers = 0;
+		messages = 0;
+		bytes = 0;
+	}
+};
+
+FakeTransfer::Sensor FakeTransfer::sensors[SENSOR_COUNT];
+uint64_t FakeTransfer::transfers = 0;
+uint64_t FakeTransfer::messages = 0;
+uint64_t FakeTransfer::bytes = 0;
+bool FakeTransfer::readLastOnly = false;
+
+using Bus = VL53L1XBatchBusT<FakeTransfer>;
+
+static void printResult(const char* method, uint64_t samples) {
+	std::printf(
+		"%-12s %6.2f syscalls/sample  %6.2f messages/sample  %6.2f bytes/sample\n",
+		method,
+		static_cast<double>(FakeTransfer::transfers) / samples,
+		static_cast<double>(FakeTransfer::messages) / samples,
+		static_cast<double>(FakeTransfer::bytes) / samples
+	);
+}
+
+/**
+ * Compare polling SENSOR_COUNT sensors one register access at a time (VL53L1XT) and in batches
+ * (VL53L1XBatchPollerT), against a simulated i2c-dev.
+ */
+int main() {
+	Bus bus;
+	std::vector<VL53L1XT<Bus>> sensors;
+	for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+		sensors.emplace_back(bus, FIRST_ADDRESS + i);
+		if (sensors.back().initialize() != VL53L1XT<Bus>::Status::OK) {
+			std::fprintf(stderr, "Initializing the sensor 0x%02x failed\n", FIRST_ADDRESS + i);
+			return 1;
+		}
+	}
+
+	// One access per syscall: status until ready, then the distance and the interrupt clear
+	FakeTransfer::resetCounters();
+	uint64_t samples = 0;
+	uint64_t checksum = 0;
+	while (samples < SAMPLES * SENSOR_COUNT) {
+		for (auto& sensor : sensors) {
+			bool ready = false;
+			uint16_t distance = 0;
+			if (sensor.isDataReady(ready) == VL53L1XT<Bus>::Status::OK && ready
+				&& sensor.readDistance(distance) == VL53L1XT<Bus>::Status::OK) {
+				checksum += distance;
+				samples++;
+			}
+		}
+	}
+	printResult("per-register", samples);
+
+	// All the sensors in a batch per syscall; then with an adapter accepting only the last message as a read
+	for (bool readLastOnly : {false, true}) {
+		FakeTransfer::readLastOnly = readLastOnly;
+		VL53L1XBatchPollerT<FakeTransfer> poller(bus);
+		for (auto& sensor : sensors) {
+			poller.addSensor(sensor.getAddress(), sensor.getInterruptPolarity());
+		}
+		VL53L1XBatchPollerT<FakeTransfer>::Result results[SENSOR_COUNT];
+		FakeTransfer::resetCounters();
+		samples = 0;
+		while (samples < SAMPLES * SENSOR_COUNT) {
+			if (poller.poll(results) != 0) {
+				std::fprintf(stderr, "Bus error\n");
+				return 1;
+			}
+			for (const auto& result : results) {
+				if (result.ready) {
+					checksum += result.distance;
+					samples++;
+				}
+			}
+		}
+		printResult(poller.isSingleReadPerTransfer() ? "read-last" : "batched", samples);
+	}
+
+	std::printf("(checksum %llu)\n", static_cast<unsigned long long>(checksum));
+	return 0;
+}
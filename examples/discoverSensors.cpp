@@ -0,0 +1,32 @@
+#include "VL53L1X.hpp"
+#include "VL53L1XDiscovery.hpp"
+#include <GPIOPin.hpp>
+#include <I2CBus.hpp>
+
+#include <iomanip>
+#include <iostream>
+
+int main() {
+	auto i2c3 = I2CBus::makeShared("/dev/i2c-3");
+	auto i2c5 = I2CBus::makeShared("/dev/i2c-5");
+
+	auto discovery3 = VL53L1XDiscovery::makeShared(i2c3, std::vector<uint8_t>{0x30, 0x31, 0x32, 0x33});
+	auto discovery5 = VL53L1XDiscovery::makeShared(i2c5, std::vector<uint8_t>{0x30, 0x31});
+
+	// This MAY throw
+	auto sensors = VL53L1XDiscovery::discoverAll({
+		{discovery3, {GPIOPin::makeShared("/sys/class/gpio/gpio6"), GPIOPin::makeShared("/sys/class/gpio/gpio16")}},
+		{discovery5, {GPIOPin::makeShared("/sys/class/gpio/gpio19")}},
+	});
+
+	for (const auto& busSensors : sensors) {
+		for (const auto& sensor : busSensors) {
+			sensor->startRanging();
+			std::cout << "0x" << std::hex << static_cast<int>(sensor->getAddress()) << std::dec << ": "
+				<< sensor->getDistance() << std::endl;
+			sensor->stopRanging();
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,43 @@
+#include "VL53L1X.hpp"
+#include "VL53L1XLinuxBus.hpp"
+#include "VL53L1XT.hpp"
+#include <I2CBus.hpp>
+
+#include <chrono>
+#include <iostream>
+
+// Register reads done by each driver
+static constexpr int ITERATIONS = 2000;
+
+/**
+ * Compare the time per data-ready poll (a single register read) of the VL53L1X and VL53L1XT drivers
+ * on the same (initialized) sensor.
+ */
+int main() {
+	auto i2c = I2CBus::makeShared("/dev/i2c-5");
+	VL53L1X sensor(i2c);
+
+	VL53L1XLinuxBus bus;
+	if (bus.open("/dev/i2c-5") != 0) {
+		std::cerr << "Opening the I2C bus failed" << std::endl;
+		return 1;
+	}
+	VL53L1XT<VL53L1XLinuxBus> sensorT(bus);
+
+	auto startTime = std::chrono::steady_clock::now();
+	for (int i = 0; i < ITERATIONS; i++) {
+		sensor.isDataReady();
+	}
+	std::chrono::duration<double, std::micro> time = std::chrono::steady_clock::now() - startTime;
+	std::cout << "VL53L1X: " << time.count() / ITERATIONS << " us/poll" << std::endl;
+
+	bool ready = false;
+	startTime = std::chrono::steady_clock::now();
+	for (int i = 0; i < ITERATIONS; i++) {
+		sensorT.isDataReady(ready);
+	}
+	time = std::chrono::steady_clock::now() - startTime;
+	std::cout << "VL53L1XT: " << time.count() / ITERATIONS << " us/poll" << std::endl;
+
+	return 0;
+}
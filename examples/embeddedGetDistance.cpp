@@ -0,0 +1,46 @@
+#include "VL53L1XLinuxBus.hpp"
+#include "VL53L1XT.hpp"
+
+#include <csignal>
+#include <cstdio>
+
+static bool exitFlag = false;
+
+void signalHandler(int signalNumber) {
+	if (signalNumber == SIGINT) {
+		exitFlag = true;
+	}
+}
+
+int main() {
+	VL53L1XLinuxBus bus;
+	if (bus.open("/dev/i2c-5") != 0) {
+		std::perror("Opening the I2C bus failed");
+		return 1;
+	}
+	VL53L1XT<VL53L1XLinuxBus> sensor(bus);
+
+	std::signal(SIGINT, signalHandler);
+
+	using Status = VL53L1XT<VL53L1XLinuxBus>::Status;
+	if (sensor.initialize() != Status::OK || sensor.startRanging() != Status::OK) {
+		std::fprintf(stderr, "Initializing the sensor failed\n");
+		return 1;
+	}
+
+	while (!exitFlag) {
+		bool ready = false;
+		if (sensor.isDataReady(ready) != Status::OK) {
+			std::fprintf(stderr, "Bus error\n");
+			break;
+		}
+		uint16_t distance = 0;
+		if (ready && sensor.readDistance(distance) == Status::OK) {
+			std::printf("%u\n", distance);
+		}
+	}
+
+	sensor.stopRanging();
+
+	return 0;
+}
@@ -0,0 +1,54 @@
+#include "VL53L1X.hpp"
+#include <I2CBus.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Register accesses done by each thread
+static constexpr int ITERATIONS = 2000;
+
+// VL53L1_IDENTIFICATION_MODEL_ID
+static constexpr uint16_t MODEL_ID_REGISTER = 0x010F;
+
+/**
+ * Compare the time per register access of raw (unsynchronized) I2CBus calls with the VL53L1X's locked ones,
+ * using 1 to 8 threads sharing the same sensor and bus.
+ * As the bus is serial, the total throughput should stay the same regardless of the number of threads.
+ */
+int main() {
+	auto i2c = I2CBus::makeShared("/dev/i2c-5");
+	auto sensor = VL53L1X::makeShared(i2c);
+
+	// Raw bus access is only safe from a single thread
+	auto startTime = std::chrono::steady_clock::now();
+	for (int i = 0; i < ITERATIONS; i++) {
+		i2c->read16Reg16(VL53L1X::DEFAULT_DEVICE_ADDRESS, MODEL_ID_REGISTER);
+	}
+	std::chrono::duration<double, std::micro> rawTime = std::chrono::steady_clock::now() - startTime;
+	double rawPerAccess = rawTime.count() / ITERATIONS;
+	std::cout << "raw, 1 thread: " << rawPerAccess << " us/access" << std::endl;
+
+	for (int threadCount : {1, 2, 4, 8}) {
+		std::vector<std::thread> threads;
+		startTime = std::chrono::steady_clock::now();
+		for (int t = 0; t < threadCount; t++) {
+			threads.emplace_back([&sensor]() {
+				for (int i = 0; i < ITERATIONS; i++) {
+					sensor->getSensorId();
+				}
+			});
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+		std::chrono::duration<double, std::micro> lockedTime = std::chrono::steady_clock::now() - startTime;
+		double lockedPerAccess = lockedTime.count() / (ITERATIONS * threadCount);
+		std::cout << "locked, " << threadCount << " threads: " << lockedPerAccess << " us/access ("
+			<< (lockedPerAccess / rawPerAccess - 1.0) * 100.0 << "% overhead)" << std::endl;
+	}
+
+	return 0;
+}
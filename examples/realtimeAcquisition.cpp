@@ -0,0 +1,63 @@
+#include "VL53L1X.hpp"
+#include "VL53L1XAcquisitionRunner.hpp"
+#include <I2CBus.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <thread>
+
+static bool exitFlag = false;
+
+void signalHandler(int signalNumber) {
+	if (signalNumber == SIGINT) {
+		exitFlag = true;
+	}
+}
+
+static void printStatistics(const char* name, const VL53L1XAcquisitionRunner::LatencyStatistics& statistics) {
+	using std::chrono::duration_cast;
+	using std::chrono::microseconds;
+	std::cout << name << " (us): p50 " << duration_cast<microseconds>(statistics.p50).count()
+		<< ", p90 " << duration_cast<microseconds>(statistics.p90).count()
+		<< ", p99 " << duration_cast<microseconds>(statistics.p99).count()
+		<< ", p99.9 " << duration_cast<microseconds>(statistics.p999).count()
+		<< ", max " << duration_cast<microseconds>(statistics.max).count()
+		<< " (" << statistics.count << " values)" << std::endl;
+}
+
+int main() {
+	auto i2c = I2CBus::makeShared("/dev/i2c-5");
+	auto sensor = VL53L1X::makeShared(i2c);
+
+	std::signal(SIGINT, signalHandler);
+
+	// This MAY throw
+	sensor->initialize();
+
+	sensor->setTimingBudget(VL53L1X::TIMING_BUDGET_20_MS);
+	sensor->setInterMeasurementPeriod(25);
+	sensor->startRanging();
+
+	std::atomic<uint16_t> distance(0);
+	// SCHED_FIFO priority 80 on CPU 1 with locked memory (needs CAP_SYS_NICE and CAP_IPC_LOCK, e.g. root)
+	VL53L1XAcquisitionRunner runner(sensor, [&distance](const VL53L1X::Sample& sample) {
+		distance = sample.distance;
+	}, 80, 1, true);
+
+	// This MAY throw
+	runner.start();
+
+	while (!exitFlag) {
+		std::this_thread::sleep_for(std::chrono::seconds(1));
+		std::cout << "Distance: " << distance << " mm" << std::endl;
+		printStatistics("Wake-up jitter", runner.getWakeUpJitter());
+		printStatistics("Sample age", runner.getSampleAge());
+	}
+
+	runner.stop();
+	sensor->stopRanging();
+
+	return 0;
+}
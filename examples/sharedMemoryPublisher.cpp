@@ -0,0 +1,35 @@
+#include "VL53L1X.hpp"
+#include "VL53L1XSharedMemoryPublisher.hpp"
+#include <I2CBus.hpp>
+
+#include <csignal>
+
+static bool exitFlag = false;
+
+void signalHandler(int signalNumber) {
+	if (signalNumber == SIGINT) {
+		exitFlag = true;
+	}
+}
+
+int main() {
+	auto i2c = I2CBus::makeShared("/dev/i2c-5");
+	VL53L1X sensor(i2c);
+
+	// This MAY throw
+	VL53L1XSharedMemoryPublisher publisher("/vl53l1x", 1);
+
+	std::signal(SIGINT, signalHandler);
+
+	// This MAY throw
+	sensor.initialize();
+
+	sensor.startRanging();
+	while (!exitFlag) {
+		publisher.publish(0, sensor.getSample(), sensor.getConfigurationEpoch());
+	}
+
+	sensor.stopRanging();
+
+	return 0;
+}
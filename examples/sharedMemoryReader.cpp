@@ -0,0 +1,38 @@
+#include "VL53L1XSharedMemory.hpp"
+
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <thread>
+
+static bool exitFlag = false;
+
+void signalHandler(int signalNumber) {
+	if (signalNumber == SIGINT) {
+		exitFlag = true;
+	}
+}
+
+int main() {
+	VL53L1XSharedMemoryReader reader;
+	if (!reader.open("/vl53l1x")) {
+		std::cerr << "Shared memory not available - is the publisher running?" << std::endl;
+		return 1;
+	}
+
+	std::signal(SIGINT, signalHandler);
+
+	while (!exitFlag) {
+		for (std::size_t i = 0; i < reader.getSensorCount(); i++) {
+			VL53L1XSharedMemoryReader::Snapshot snapshot = {};
+			if (reader.read(i, snapshot)) {
+				auto age = std::chrono::steady_clock::now() - snapshot.timestamp;
+				std::cout << i << ": " << snapshot.distance << " mm, "
+					<< std::chrono::duration_cast<std::chrono::microseconds>(age).count() << " us old" << std::endl;
+			}
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	}
+
+	return 0;
+}
@@ -0,0 +1,64 @@
+#include "VL53L1X.hpp"
+#include "VL53L1XSupervisor.hpp"
+#include <GPIOPin.hpp>
+#include <I2CBus.hpp>
+
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <thread>
+
+static bool exitFlag = false;
+
+void signalHandler(int signalNumber) {
+	if (signalNumber == SIGINT) {
+		exitFlag = true;
+	}
+}
+
+int main() {
+	auto i2c = I2CBus::makeShared("/dev/i2c-3");
+	auto gpio6 = GPIOPin::makeShared("/sys/class/gpio/gpio6");
+	auto gpio16 = GPIOPin::makeShared("/sys/class/gpio/gpio16");
+
+	auto sensor1 = VL53L1X::makeShared(i2c, gpio6);
+	auto sensor2 = VL53L1X::makeShared(i2c, gpio16);
+
+	std::signal(SIGINT, signalHandler);
+
+	sensor1->powerOff();
+	sensor2->powerOff();
+
+	sensor1->powerOn();
+	sensor1->setAddress(0x29 + 1);
+	sensor2->powerOn();
+	sensor2->setAddress(0x29 + 2);
+
+	// This MAY throw
+	sensor1->initialize();
+	sensor2->initialize();
+
+	sensor1->startRanging();
+	sensor2->startRanging();
+
+	VL53L1XSupervisor supervisor;
+	auto index1 = supervisor.addSensor(sensor1);
+	auto index2 = supervisor.addSensor(sensor2);
+
+	while (!exitFlag) {
+		supervisor.poll();
+		std::cout << supervisor.getDistance(index1) << " " << supervisor.getDistance(index2) << std::endl;
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	}
+
+	for (auto index : {index1, index2}) {
+		auto metrics = supervisor.getRecoveryMetrics(index);
+		std::cout << "sensor " << index << ": " << metrics.faults << " faults, " << metrics.recoveries
+			<< " recoveries, max recovery time " << metrics.maxLatency.count() << " us" << std::endl;
+	}
+
+	sensor1->stopRanging();
+	sensor2->stopRanging();
+
+	return 0;
+}
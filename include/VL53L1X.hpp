@@ -1,5 +1,7 @@
 #pragma once
 
+#include "VL53L1XDefinitions.hpp"
+
 #include <GPIOPin.hpp>
 #include <I2CBus.hpp>
 
@@ -7,9 +9,22 @@
 #include <cstdint>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 
-class VL53L1X: public std::enable_shared_from_this<VL53L1X> {
+#include <pthread.h>
+
+/**
+ * VL53L1X sensor driver.
+ *
+ * All the methods are thread-safe: each multi-register sequence (e.g. VL53L1X::setDistanceMode()) is performed while
+ * holding the mutex of the I2C bus, shared by all the sensors using the same I2CBus instance, and the sensor's own
+ * state is guarded by a per-sensor mutex. The bus mutex is never held while waiting for data.
+ *
+ * Both mutexes use priority inheritance (VL53L1X::Mutex): a real-time thread waiting for a sensor (e.g. in
+ * VL53L1XAcquisitionRunner) boosts the thread holding it, instead of being held off by threads of medium priority.
+ */
+class VL53L1X: public std::enable_shared_from_this<VL53L1X>, private VL53L1XDefinitions {
 public:
 	/**
 	 * A shared_ptr alias (use as VL53L1X::SharedPtr)
@@ -21,14 +36,76 @@ public:
 	 */
 	using ConstSharedPtr = std::shared_ptr<const VL53L1X>;
 
+	/**
+	 * The I2C address the sensor answers at after powering on
+	 */
+	using VL53L1XDefinitions::DEFAULT_DEVICE_ADDRESS;
+
+	/**
+	 * The value of the model ID register (model ID and module type) of a VL53L1X
+	 */
+	using VL53L1XDefinitions::SENSOR_ID;
+
+	/**
+	 * Time for which the XSHUT pin is held low to reset the sensor before powering it on again
+	 */
+	static constexpr std::chrono::milliseconds POWER_OFF_DURATION = std::chrono::milliseconds(10);
+
 	/**
 	 * Available distance measuring modes, used in VL53L1X::setDistanceMode()
 	 */
 	enum DistanceMode : uint8_t {
 		DISTANCE_MODE_SHORT,
 		DISTANCE_MODE_LONG,
-		DISTANCE_MODE_UNKNOWN
-		// Medium: TBD
+		DISTANCE_MODE_UNKNOWN,
+		DISTANCE_MODE_MEDIUM
+	};
+
+	/**
+	 * A distance measurement along with the host time of its data-ready detection, returned by VL53L1X::getSample()
+	 */
+	struct Sample {
+		/**
+		 * The measured distance in mm (special values as in VL53L1X::getDistance())
+		 */
+		uint16_t distance;
+
+		/**
+		 * The time at which the data was detected as ready (not when it was read)
+		 */
+		std::chrono::steady_clock::time_point timestamp;
+	};
+
+	/**
+	 * Recursive mutex with priority inheritance (PTHREAD_PRIO_INHERIT), guarding the sensors and the buses
+	 *
+	 * std::recursive_mutex can't be configured for priority inheritance. Meets the Lockable requirements, so it can be
+	 * used with std::lock_guard, std::unique_lock and std::scoped_lock.
+	 */
+	class Mutex {
+	public:
+		/**
+		 * @throws std::system_error if the mutex can't be created
+		 */
+		Mutex();
+
+		Mutex(const Mutex&) = delete;
+
+		Mutex& operator=(const Mutex&) = delete;
+
+		~Mutex();
+
+		/**
+		 * @throws std::system_error if locking fails
+		 */
+		void lock();
+
+		bool try_lock();
+
+		void unlock();
+
+	private:
+		pthread_mutex_t mutex;
 	};
 
 	/**
@@ -66,6 +143,21 @@ public:
 	 */
 	void initialize();
 
+	/**
+	 * First, non-blocking half of VL53L1X::initialize()
+	 *
+	 * Loads the default configuration and starts the initial (VHV) measurement.
+	 * Once VL53L1X::isDataReady() returns true, VL53L1X::finishInitialization() must be called.
+	 */
+	void loadDefaultConfiguration();
+
+	/**
+	 * Second, non-blocking half of VL53L1X::initialize()
+	 *
+	 * @see VL53L1X::loadDefaultConfiguration()
+	 */
+	void finishInitialization();
+
 	/**
 	 * Power on the sensor by setting its XSHUT pin to high via host's GPIO.
 	 */
@@ -81,6 +173,45 @@ public:
 	 */
 	void setAddress(uint8_t newAddress);
 
+	/**
+	 * Get the sensor's I2C address, as known by this object.
+	 *
+	 * @return The I2C address
+	 */
+	uint8_t getAddress() const;
+
+	/**
+	 * Re-assign the sensor's address after a power cycle.
+	 *
+	 * After powering on, the sensor always answers at the default address; this moves it back to the address
+	 * stored in this object. Does nothing if the sensor can't be power-cycled or the address is the default one.
+	 */
+	void restoreAddress();
+
+	/**
+	 * Re-apply the configuration and calibration cached from previous setter calls.
+	 *
+	 * Meant to be called after re-initializing the sensor (e.g. after a power cycle).
+	 * Restarts ranging if it was active before.
+	 */
+	void restoreConfiguration();
+
+	/**
+	 * Get the configuration epoch - a counter incremented on every configuration or calibration change
+	 *
+	 * Lets consumers of the samples (e.g. VL53L1XSharedMemoryReader) detect that the configuration changed.
+	 *
+	 * @return The configuration epoch
+	 */
+	uint32_t getConfigurationEpoch() const;
+
+	/**
+	 * Read the sensor's model ID and module type
+	 *
+	 * @return The sensor ID, VL53L1X::SENSOR_ID for a VL53L1X
+	 */
+	uint16_t getSensorId();
+
 	/**
 	 * Start the continuous ranging operation
 	 */
@@ -109,13 +240,34 @@ public:
 	 */
 	uint16_t getDistance();
 
+	/**
+	 * Get the distance measured by the sensor along with the time of detecting it.
+	 *
+	 * Blocks like VL53L1X::getDistance(); the timestamp is captured as soon as the data is detected as ready.
+	 * For a better estimate of the actual acquisition time, see VL53L1XClockEstimator.
+	 *
+	 * @return The measured sample
+	 */
+	VL53L1X::Sample getSample();
+
+	/**
+	 * Read the sample if the data is ready, without blocking.
+	 *
+	 * @param sample The read sample (unchanged if not ready)
+	 *
+	 * @return True if a sample was read
+	 */
+	bool tryGetSample(VL53L1X::Sample& sample);
+
 	/**
 	 * Clear the interrupt flag of the sensor
 	 */
 	void clearInterrupt();
 
 	/**
-	 * Set the distance mode, long: 0~4m, short: 0~1.3m
+	 * Set the distance mode, long: 0~4m, medium: 0~3m, short: 0~1.3m
+	 *
+	 * The current timing budget is preserved.
 	 *
 	 * @param mode The new mode
 	 */
@@ -132,6 +284,7 @@ public:
 	 * Set the timing budget
 	 *
 	 * @see VL53L1X::TimingBudget for possible values
+	 * @note 15 ms is only available in the short distance mode (ignored in the other modes)
 	 *
 	 * @param timingBudget The timing budget to set
 	 */
@@ -140,10 +293,29 @@ public:
 	/**
 	 * Get the current timing budget in ms
 	 *
-	 * @return timing budget
+	 * @return timing budget (the nearest VL53L1X::TimingBudget if the budget was set with
+	 * VL53L1X::setTimingBudgetMs() or in the medium distance mode; 20 ms if it can't be determined)
 	 */
 	VL53L1X::TimingBudget getTimingBudget();
 
+	/**
+	 * Set an arbitrary timing budget, in ms
+	 *
+	 * Values from VL53L1X::TimingBudget use ST's tuned register values in the short and long modes,
+	 * other values (and all values in the medium mode) are calculated from the sensor's macro period.
+	 *
+	 * @param timingBudgetMs The timing budget to set (range: 13 ~ 1112 in the short mode, 20 ~ 1112 in the medium and
+	 * long modes; other values are ignored)
+	 */
+	void setTimingBudgetMs(uint16_t timingBudgetMs);
+
+	/**
+	 * Get the current timing budget in ms, including values not in VL53L1X::TimingBudget
+	 *
+	 * @return timing budget
+	 */
+	uint16_t getTimingBudgetMs();
+
 	/**
 	 * Set the inter-measurement period (IMP) in ms
 	 *
@@ -158,6 +330,15 @@ public:
 	 */
 	uint16_t getInterMeasurementPeriod();
 
+	/**
+	 * Get the inter-measurement period as programmed in the sensor, at sub-millisecond resolution
+	 *
+	 * Calculated from the raw period register and the sensor's oscillator calibration value.
+	 *
+	 * @return The inter-measurement period (0 if the oscillator is not calibrated)
+	 */
+	std::chrono::nanoseconds getMeasurementPeriod();
+
 	/**
 	 * Apply the correction offset value (in millimeters) to the sensor
 	 *
@@ -225,6 +406,19 @@ public:
 	 */
 	int8_t calibrateCrosstalk(uint16_t targetDistance);
 
+	/**
+	 * Get the mutex guarding the transactions on an I2C bus, shared by all the VL53L1X instances on that bus.
+	 *
+	 * Lock it to perform own transactions on the bus (e.g. with other devices) without interleaving with the sensors.
+	 *
+	 * @note Don't call VL53L1X methods while holding it - the per-sensor mutex must be locked first.
+	 *
+	 * @param i2cBus The I2C bus
+	 *
+	 * @return The bus mutex
+	 */
+	static std::shared_ptr<VL53L1X::Mutex> getBusMutex(const I2CBus::SharedPtr& i2cBus);
+
 	/**
 	 * Create a SharedPtr instance of the VL53L1X.
 	 *
@@ -237,13 +431,30 @@ public:
 	}
 
 private:
-	static constexpr uint8_t DEFAULT_DEVICE_ADDRESS = 0x29;
+	/**
+	 * Values written by the user, re-applied by VL53L1X::restoreConfiguration()
+	 */
+	struct CachedConfiguration {
+		std::optional<VL53L1X::DistanceMode> distanceMode;
+		std::optional<uint16_t> timingBudgetMs;
+		std::optional<uint16_t> interMeasurementPeriod;
+		std::optional<int16_t> offset;
+		// Raw register value, as calibrateCrosstalk() writes it directly
+		std::optional<uint16_t> crosstalk;
+		bool ranging = false;
+	};
 
-	static const uint8_t DEFAULT_CONFIGURATION[91];
+	I2CBus::SharedPtr i2cBus;
 
-	enum RegisterAddresses : uint16_t;
+	/**
+	 * Guards the transactions on the bus, shared with the other sensors on the same bus
+	 */
+	std::shared_ptr<VL53L1X::Mutex> busMutex;
 
-	I2CBus::SharedPtr i2cBus;
+	/**
+	 * Guards this sensor's state; always locked before the bus mutex
+	 */
+	mutable VL53L1X::Mutex stateMutex;
 
 	GPIOPin::SharedPtr gpioPin;
 
@@ -261,54 +472,28 @@ private:
 	 */
 	double decimal;
 
+	CachedConfiguration cachedConfiguration;
+
+	uint32_t configurationEpoch;
+
+	// lock both the sensor state and the bus for a whole transaction
+	std::scoped_lock<VL53L1X::Mutex, VL53L1X::Mutex> lockTransaction();
+
 	// get signal rate
 	uint16_t getSignalRate();
 
 	// set Sigma Threshold
 	void setSigmaThreshold(uint16_t Sigma);
-};
 
-enum VL53L1X::RegisterAddresses : uint16_t {
-	SOFT_RESET = 0x0000,
-	I2C_SLAVE_DEVICE_ADDRESS = 0x0001,
-	VHV_CONFIG_TIMEOUT_MACROP_LOOP_BOUND = 0x0008,
-	VHV_CONFIG_INIT = 0x000B,
-	ALGO_CROSSTALK_COMPENSATION_PLANE_OFFSET_KCPS = 0x0016,
-	ALGO_CROSSTALK_COMPENSATION_X_PLANE_GRADIENT_KCPS = 0x0018,
-	ALGO_CROSSTALK_COMPENSATION_Y_PLANE_GRADIENT_KCPS = 0x001A,
-	ALGO_PART_TO_PART_RANGE_OFFSET_MM = 0x001E,
-	MM_CONFIG_INNER_OFFSET_MM = 0x0020,
-	MM_CONFIG_OUTER_OFFSET_MM = 0x0022,
-	GPIO_HV_MUX_CTRL = 0x0030,
-	GPIO_TIO_HV_STATUS = 0x0031,
-	SYSTEM_INTERRUPT_CONFIG_GPIO = 0x0046,
-	PHASECAL_CONFIG_TIMEOUT_MACROP = 0x004B,
-	RANGE_CONFIG_TIMEOUT_MACROP_A_HI = 0x005E,
-	RANGE_CONFIG_VCSEL_PERIOD_A = 0x0060,
-	RANGE_CONFIG_VCSEL_PERIOD_B = 0x0063,
-	RANGE_CONFIG_TIMEOUT_MACROP_B_HI = 0x0061,
-	RANGE_CONFIG_TIMEOUT_MACROP_B_LO = 0x0062,
-	RANGE_CONFIG_SIGMA_THRESH = 0x0064,
-	RANGE_CONFIG_MIN_COUNT_RATE_RTN_LIMIT_MCPS = 0x0066,
-	RANGE_CONFIG_VALID_PHASE_HIGH = 0x0069,
-	VL53L1_SYSTEM_INTERMEASUREMENT_PERIOD = 0x006C,
-	SYSTEM_THRESH_HIGH = 0x0072,
-	SYSTEM_THRESH_LOW = 0x0074,
-	SD_CONFIG_WOI_SD0 = 0x0078,
-	SD_CONFIG_INITIAL_PHASE_SD0 = 0x007A,
-	ROI_CONFIG_USER_ROI_CENTRE_SPAD = 0x007F,
-	ROI_CONFIG_USER_ROI_REQUESTED_GLOBAL_XY_SIZE = 0x0080,
-	SYSTEM_SEQUENCE_CONFIG = 0x0081,
-	VL53L1_SYSTEM_GROUPED_PARAMETER_HOLD = 0x0082,
-	SYSTEM_INTERRUPT_CLEAR = 0x0086,
-	SYSTEM_MODE_START = 0x0087,
-	VL53L1_RESULT_RANGE_STATUS = 0x0089,
-	VL53L1_RESULT_DSS_ACTUAL_EFFECTIVE_SPADS_SD0 = 0x008C,
-	RESULT_AMBIENT_COUNT_RATE_MCPS_SD = 0x0090,
-	VL53L1_RESULT_FINAL_CROSSTALK_CORRECTED_RANGE_MM_SD0 = 0x0096,
-	VL53L1_RESULT_PEAK_SIGNAL_COUNT_RATE_CROSSTALK_CORRECTED_MCPS_SD0 = 0x0098,
-	VL53L1_RESULT_OSC_CALIBRATE_VAL = 0x00DE,
-	VL53L1_FIRMWARE_SYSTEM_STATUS = 0x00E5,
-	VL53L1_IDENTIFICATION_MODEL_ID = 0x010F,
-	VL53L1_ROI_CONFIG_MODE_ROI_CENTRE_SPAD = 0x013E,
+	// find ST's tuned settings of a timing budget, nullptr if there are none for the mode
+	static const TimingBudgetSettings* findTimingBudgetSettings(VL53L1X::DistanceMode mode, uint16_t timingBudgetMs);
+
+	// look up the budget (in ms) of ST's timing budget tables, 0 if not found
+	static uint16_t lookUpTimingBudget(VL53L1X::DistanceMode mode, uint16_t configValue);
+
+	// get the macro period (in us, 12.12 format) for a VCSEL period register value
+	uint32_t getMacroPeriod(uint8_t vcselPeriod);
+
+	// calculate and write the range timeouts for the given budget, returns false if nothing was written
+	bool writeTimingBudget(uint32_t timingBudgetUs);
 };
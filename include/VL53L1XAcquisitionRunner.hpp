@@ -0,0 +1,214 @@
+#pragma once
+
+#include "VL53L1X.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/**
+ * Real-time acquisition thread for a continuously ranging VL53L1X.
+ *
+ * Instead of sleeping for fixed intervals, the thread sleeps until absolute deadlines (clock_nanosleep on
+ * CLOCK_MONOTONIC) aligned to the sensor's measurement grid, as tracked by VL53L1XClockEstimator: it wakes shortly
+ * before the next sample is expected and polls at short intervals until it's ready. The thread can optionally run
+ * with SCHED_FIFO priority, pinned to a CPU and with the process memory locked.
+ *
+ * To verify the latency, the runner records:
+ *  - the wake-up jitter: how late the thread woke up relative to its deadline;
+ *  - the sample age: the time from the estimated data-ready to handing the sample to the callback.
+ *
+ * @note The sensor must be ranging (with a constant inter-measurement period) before starting the runner.
+ *
+ * @note Avoid using the sensor, or other sensors on its bus, from other threads while the runner is active: each poll
+ * waits for the sensor and bus mutexes. Priority inheritance bounds the wait to the other thread's current operation,
+ * but that may be long - e.g. VL53L1X::calibrateOffset() holds the sensor for all of its measurements.
+ */
+class VL53L1XAcquisitionRunner {
+public:
+	/**
+	 * A shared_ptr alias (use as VL53L1XAcquisitionRunner::SharedPtr)
+	 */
+	using SharedPtr = std::shared_ptr<VL53L1XAcquisitionRunner>;
+
+	using Clock = std::chrono::steady_clock;
+
+	/**
+	 * Called from the acquisition thread with every new sample
+	 */
+	using Callback = std::function<void(const VL53L1X::Sample&)>;
+
+	/**
+	 * Latency percentiles, over the last VL53L1XAcquisitionRunner::HISTORY_SIZE values
+	 */
+	struct LatencyStatistics {
+		/**
+		 * Number of values recorded since starting (or resetting)
+		 */
+		uint64_t count = 0;
+
+		std::chrono::nanoseconds p50 = std::chrono::nanoseconds(0);
+
+		std::chrono::nanoseconds p90 = std::chrono::nanoseconds(0);
+
+		std::chrono::nanoseconds p99 = std::chrono::nanoseconds(0);
+
+		std::chrono::nanoseconds p999 = std::chrono::nanoseconds(0);
+
+		/**
+		 * Maximum since starting (or resetting), not just over the history
+		 */
+		std::chrono::nanoseconds max = std::chrono::nanoseconds(0);
+	};
+
+	/**
+	 * Number of recent values the percentiles are computed from
+	 */
+	static constexpr std::size_t HISTORY_SIZE = 4096;
+
+	/**
+	 * Create a new runner (the thread is started with VL53L1XAcquisitionRunner::start()).
+	 *
+	 * @param sensor The sensor (initialized and ranging)
+	 * @param callback The function receiving the samples, called from the acquisition thread
+	 * @param priority The SCHED_FIFO priority (1 ~ 99) of the thread, 0 to keep the default scheduling
+	 * @param cpu The CPU to pin the thread to, -1 to not pin it
+	 * @param lockMemory Whether to lock the whole process memory (mlockall), so that the thread doesn't page-fault
+	 */
+	VL53L1XAcquisitionRunner(
+		VL53L1X::SharedPtr sensor,
+		Callback callback,
+		int priority = 0,
+		int cpu = -1,
+		bool lockMemory = false
+	);
+
+	VL53L1XAcquisitionRunner(const VL53L1XAcquisitionRunner&) = delete;
+
+	VL53L1XAcquisitionRunner& operator=(const VL53L1XAcquisitionRunner&) = delete;
+
+	/**
+	 * Stop the thread (if running).
+	 */
+	~VL53L1XAcquisitionRunner();
+
+	/**
+	 * Start the acquisition thread.
+	 *
+	 * Reads the sensor's period and timing budget, then starts the thread and applies the real-time settings.
+	 *
+	 * @throws std::system_error if a real-time setting can't be applied (e.g. missing CAP_SYS_NICE for SCHED_FIFO)
+	 * @throws std::runtime_error if the sensor's period can't be determined
+	 */
+	void start();
+
+	/**
+	 * Stop the acquisition thread and wait for it to finish (at most about one period).
+	 */
+	void stop();
+
+	/**
+	 * Check whether the acquisition thread is running.
+	 */
+	bool isRunning() const;
+
+	/**
+	 * Get the wake-up jitter statistics (actual wake-up time minus the deadline).
+	 */
+	VL53L1XAcquisitionRunner::LatencyStatistics getWakeUpJitter() const;
+
+	/**
+	 * Get the sample age statistics (time of calling the callback minus the estimated data-ready time).
+	 */
+	VL53L1XAcquisitionRunner::LatencyStatistics getSampleAge() const;
+
+	/**
+	 * Get the number of failed polls (bus errors and exceptions thrown from the callback).
+	 */
+	uint64_t getErrorCount() const;
+
+	/**
+	 * Clear the recorded statistics and the error count.
+	 *
+	 * The statistics read as empty right away; the acquisition thread drops the old values on recording the next one.
+	 */
+	void resetStatistics();
+
+	/**
+	 * Create a SharedPtr instance of the VL53L1XAcquisitionRunner.
+	 *
+	 * Usage: `VL53L1XAcquisitionRunner::makeShared(args...)`.
+	 * See constructor (@ref VL53L1XAcquisitionRunner::VL53L1XAcquisitionRunner()) for details.
+	 */
+	template<typename ... Args>
+	static VL53L1XAcquisitionRunner::SharedPtr makeShared(Args&& ... args) {
+		return std::make_shared<VL53L1XAcquisitionRunner>(std::forward<Args>(args) ...);
+	}
+
+private:
+	/**
+	 * Fixed-size history of latency values, preallocated so that recording doesn't allocate.
+	 *
+	 * Lock-free, so that readers can't block (or priority-invert) the acquisition thread: only that thread writes,
+	 * readers copy the values and may get some overwritten by newer ones while copying.
+	 */
+	struct LatencyHistory {
+		std::vector<std::atomic<int64_t>> values = std::vector<std::atomic<int64_t>>(HISTORY_SIZE);
+		std::atomic<uint64_t> count = 0;
+		std::atomic<int64_t> max = 0;
+		std::atomic<bool> resetRequested = false;
+	};
+
+	/**
+	 * How long before the expected data-ready the thread wakes up
+	 */
+	static constexpr std::chrono::microseconds WAKE_ADVANCE = std::chrono::microseconds(1000);
+
+	/**
+	 * Interval of the data-ready polls after waking up
+	 */
+	static constexpr std::chrono::microseconds POLL_INTERVAL = std::chrono::microseconds(250);
+
+	/**
+	 * Size of the stack prefaulted when locking memory
+	 */
+	static constexpr std::size_t STACK_PREFAULT_SIZE = 64 * 1024;
+
+	const VL53L1X::SharedPtr sensor;
+
+	const Callback callback;
+
+	const int priority;
+
+	const int cpu;
+
+	const bool lockMemory;
+
+	std::thread thread;
+
+	std::atomic<bool> running;
+
+	std::atomic<uint64_t> errorCount;
+
+	LatencyHistory wakeUpJitter;
+
+	LatencyHistory sampleAge;
+
+	void run(std::promise<void> started, std::chrono::nanoseconds period, std::chrono::nanoseconds timingBudget);
+
+	void configureThread() const;
+
+	static void record(LatencyHistory& history, Clock::duration value);
+
+	static void applyReset(LatencyHistory& history);
+
+	static LatencyStatistics getStatistics(const LatencyHistory& history);
+
+	static void sleepUntil(Clock::time_point deadline);
+};
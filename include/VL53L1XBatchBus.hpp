@@ -0,0 +1,390 @@
+#pragma once
+
+#include "VL53L1XDefinitions.hpp"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <fcntl.h>
+#include <linux/i2c-dev.h>
+#include <linux/i2c.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+/**
+ * The i2c-dev transfer used by VL53L1XBatchBusT: a single I2C_RDWR ioctl.
+ *
+ * Replaceable (as a template parameter) to run the bus against a simulated device.
+ */
+struct VL53L1XI2CDevTransfer {
+	static int transfer(int fd, i2c_msg* messages, uint32_t count) noexcept {
+		i2c_rdwr_ioctl_data data = {messages, count};
+		return ::ioctl(fd, I2C_RDWR, &data) < 0 ? -errno : 0;
+	}
+};
+
+/**
+ * i2c-dev bus that queues register accesses and submits them as multiple messages of a single I2C_RDWR ioctl.
+ *
+ * Meant for polling many sensors on one bus: queue the accesses of a whole polling round (e.g. with
+ * VL53L1XBatchPollerT) and submit them at once, instead of paying the syscall and adapter overhead per register.
+ * It also implements the VL53L1XT bus policy (immediate accesses), so the same instance can be used to set up
+ * the sensors. No exceptions, no allocations; methods return 0 on success or a negative errno value.
+ *
+ * @note The queued read buffers must stay valid until VL53L1XBatchBusT::submit() returns.
+ * @note Some adapters only accept a read as the last message of a transfer (e.g. i2c-bcm2835 on Raspberry Pi) and
+ * fail the transfer with -EOPNOTSUPP otherwise; submit a single read per transfer for these.
+ */
+template<typename Transfer = VL53L1XI2CDevTransfer>
+class VL53L1XBatchBusT {
+public:
+	/**
+	 * Maximal number of queued messages (the kernel's limit for a single I2C_RDWR ioctl)
+	 */
+	static constexpr std::size_t MAX_MESSAGES = I2C_RDWR_IOCTL_MAX_MSGS;
+
+	/**
+	 * Maximal number of data bytes in a queued write
+	 */
+	static constexpr uint8_t MAX_QUEUED_WRITE_LENGTH = 4;
+
+	/**
+	 * Maximal number of data bytes in an immediate write
+	 */
+	static constexpr uint8_t MAX_WRITE_LENGTH = 128;
+
+	VL53L1XBatchBusT() noexcept = default;
+
+	VL53L1XBatchBusT(const VL53L1XBatchBusT&) = delete;
+
+	VL53L1XBatchBusT& operator=(const VL53L1XBatchBusT&) = delete;
+
+	~VL53L1XBatchBusT() {
+		this->close();
+	}
+
+	/**
+	 * Open the bus device.
+	 *
+	 * @param path The path to the bus device, e.g. "/dev/i2c-1"
+	 *
+	 * @return 0 or a negative errno value
+	 */
+	int open(const char* path) noexcept {
+		this->close();
+		this->fd = ::open(path, O_RDWR);
+		return this->fd < 0 ? -errno : 0;
+	}
+
+	/**
+	 * Close the bus device (does nothing if not open).
+	 */
+	void close() noexcept {
+		if (this->fd >= 0) {
+			::close(this->fd);
+			this->fd = -1;
+		}
+	}
+
+	/**
+	 * Get the number of free message slots in the queue (a read takes 2, a write 1).
+	 */
+	std::size_t getFreeMessageCount() const noexcept {
+		return VL53L1XBatchBusT::MAX_MESSAGES - this->messageCount;
+	}
+
+	/**
+	 * Queue a read of consecutive registers.
+	 *
+	 * @return 0, or -ENOSPC if the queue is full
+	 */
+	int queueRead(uint8_t deviceAddress, uint16_t registerAddress, uint8_t* data, uint8_t length) noexcept {
+		if (this->getFreeMessageCount() < 2) {
+			return -ENOSPC;
+		}
+		uint8_t* buffer = this->buffers[this->messageCount];
+		buffer[0] = static_cast<uint8_t>(registerAddress >> 8);
+		buffer[1] = static_cast<uint8_t>(registerAddress);
+		this->messages[this->messageCount++] = {deviceAddress, 0, 2, buffer};
+		this->messages[this->messageCount++] = {deviceAddress, I2C_M_RD, length, data};
+		return 0;
+	}
+
+	/**
+	 * Queue a write of consecutive registers (the data is copied).
+	 *
+	 * @return 0, -ENOSPC if the queue is full or -EINVAL if the data is too long
+	 */
+	int queueWrite(uint8_t deviceAddress, uint16_t registerAddress, const uint8_t* data, uint8_t length) noexcept {
+		if (length > VL53L1XBatchBusT::MAX_QUEUED_WRITE_LENGTH) {
+			return -EINVAL;
+		}
+		if (this->getFreeMessageCount() < 1) {
+			return -ENOSPC;
+		}
+		uint8_t* buffer = this->buffers[this->messageCount];
+		buffer[0] = static_cast<uint8_t>(registerAddress >> 8);
+		buffer[1] = static_cast<uint8_t>(registerAddress);
+		std::memcpy(&buffer[2], data, length);
+		this->messages[this->messageCount++] = {deviceAddress, 0, static_cast<uint16_t>(2 + length), buffer};
+		return 0;
+	}
+
+	/**
+	 * Submit all the queued messages in a single transfer and clear the queue.
+	 *
+	 * @return 0 (also if the queue was empty) or a negative errno value
+	 */
+	int submit() noexcept {
+		if (this->messageCount == 0) {
+			return 0;
+		}
+		int result = this->transfer(this->messages, static_cast<uint32_t>(this->messageCount));
+		this->messageCount = 0;
+		return result;
+	}
+
+	/**
+	 * Read consecutive registers immediately (VL53L1XT bus policy).
+	 */
+	int readRegister(uint8_t deviceAddress, uint16_t registerAddress, uint8_t* data, uint8_t length) noexcept {
+		uint8_t registerBuffer[2] = {static_cast<uint8_t>(registerAddress >> 8), static_cast<uint8_t>(registerAddress)};
+		i2c_msg messages[2] = {
+			{deviceAddress, 0, 2, registerBuffer},
+			{deviceAddress, I2C_M_RD, length, data},
+		};
+		return this->transfer(messages, 2);
+	}
+
+	/**
+	 * Write consecutive registers immediately (VL53L1XT bus policy).
+	 */
+	int writeRegister(uint8_t deviceAddress, uint16_t registerAddress, const uint8_t* data, uint8_t length) noexcept {
+		if (length > VL53L1XBatchBusT::MAX_WRITE_LENGTH) {
+			return -EINVAL;
+		}
+		uint8_t buffer[2 + VL53L1XBatchBusT::MAX_WRITE_LENGTH];
+		buffer[0] = static_cast<uint8_t>(registerAddress >> 8);
+		buffer[1] = static_cast<uint8_t>(registerAddress);
+		std::memcpy(&buffer[2], data, length);
+		i2c_msg message = {deviceAddress, 0, static_cast<uint16_t>(2 + length), buffer};
+		return this->transfer(&message, 1);
+	}
+
+	/**
+	 * Get the number of transfers (syscalls) done so far.
+	 */
+	uint64_t getTransferCount() const noexcept {
+		return this->transferCount;
+	}
+
+private:
+	int fd = -1;
+
+	i2c_msg messages[MAX_MESSAGES] = {};
+
+	/**
+	 * Register address (and write data) buffers, one per queued message
+	 */
+	uint8_t buffers[MAX_MESSAGES][2 + MAX_QUEUED_WRITE_LENGTH] = {};
+
+	std::size_t messageCount = 0;
+
+	uint64_t transferCount = 0;
+
+	int transfer(i2c_msg* transferMessages, uint32_t count) noexcept {
+		this->transferCount++;
+		return Transfer::transfer(this->fd, transferMessages, count);
+	}
+};
+
+using VL53L1XBatchBus = VL53L1XBatchBusT<>;
+
+/**
+ * Polls multiple continuously ranging sensors on one bus with batched transfers.
+ *
+ * Every round is one transfer reading the data-ready status and the distance of all the sensors (the distance of
+ * sensors which are not ready is discarded), plus one transfer clearing the interrupts of the ready ones.
+ * With more sensors than fit in a single transfer, the reads are split into as few transfers as possible.
+ *
+ * Adapters which only accept a read as the last message of a transfer (e.g. i2c-bcm2835 on Raspberry Pi) reject
+ * these batches with -EOPNOTSUPP. The poller then switches to one register read per transfer (as can be requested
+ * up front in the constructor): the status of every sensor, then the distance of the ready ones, followed by a
+ * single transfer clearing the interrupts.
+ *
+ * The sensors must be initialized beforehand (e.g. with VL53L1XT on the same bus).
+ */
+template<typename Transfer = VL53L1XI2CDevTransfer>
+class VL53L1XBatchPollerT: private VL53L1XDefinitions {
+public:
+	/**
+	 * Maximal number of polled sensors
+	 */
+	static constexpr std::size_t MAX_SENSORS = 32;
+
+	/**
+	 * Result of polling a single sensor
+	 */
+	struct Result {
+		/**
+		 * Whether a new sample was ready (otherwise `distance` is not valid)
+		 */
+		bool ready;
+
+		/**
+		 * The measured distance in mm (16384 means out-of-range)
+		 */
+		uint16_t distance;
+	};
+
+	/**
+	 * Create a new poller.
+	 *
+	 * @param bus The bus the sensors are on (must outlive the poller)
+	 * @param singleReadPerTransfer Whether to submit a single register read per transfer right away, instead of
+	 * switching to it after the adapter rejects a batch
+	 */
+	explicit VL53L1XBatchPollerT(VL53L1XBatchBusT<Transfer>& bus, bool singleReadPerTransfer = false) noexcept:
+		bus(bus),
+		singleReadPerTransfer(singleReadPerTransfer) {}
+
+	/**
+	 * Add a sensor to be polled.
+	 *
+	 * @param address The sensor's I2C address
+	 * @param interruptPolarity The sensor's interrupt polarity (see VL53L1XT::getInterruptPolarity())
+	 *
+	 * @return The sensor index, or -1 if there are already VL53L1XBatchPollerT::MAX_SENSORS sensors
+	 */
+	int addSensor(uint8_t address, uint8_t interruptPolarity) noexcept {
+		if (this->sensorCount == VL53L1XBatchPollerT::MAX_SENSORS) {
+			return -1;
+		}
+		this->sensors[this->sensorCount] = {address, interruptPolarity};
+		return static_cast<int>(this->sensorCount++);
+	}
+
+	/**
+	 * Poll all the sensors once.
+	 *
+	 * @param results The results, one per sensor (in the order of adding)
+	 *
+	 * @return 0 or a negative errno value
+	 */
+	int poll(Result* results) noexcept {
+		int result = this->readSensors(results);
+		if (result == -EOPNOTSUPP && !this->singleReadPerTransfer) {
+			// Nothing was written yet, so the round can simply be repeated
+			this->singleReadPerTransfer = true;
+			result = this->readSensors(results);
+		}
+		if (result != 0) {
+			return result;
+		}
+
+		// Clear the interrupts of the sensors which had new data (write-only, accepted by all adapters)
+		static constexpr uint8_t CLEAR_INTERRUPT = 0x01;
+		for (std::size_t i = 0; i < this->sensorCount; i++) {
+			if (!results[i].ready) {
+				continue;
+			}
+			if (this->bus.getFreeMessageCount() < 1) {
+				result = this->bus.submit();
+				if (result != 0) {
+					return result;
+				}
+			}
+			this->bus.queueWrite(this->sensors[i].address, SYSTEM_INTERRUPT_CLEAR, &CLEAR_INTERRUPT, 1);
+		}
+		return this->bus.submit();
+	}
+
+	/**
+	 * Check whether the poller submits a single register read per transfer (requested or detected).
+	 */
+	bool isSingleReadPerTransfer() const noexcept {
+		return this->singleReadPerTransfer;
+	}
+
+private:
+	struct Sensor {
+		uint8_t address;
+		uint8_t interruptPolarity;
+	};
+
+	VL53L1XBatchBusT<Transfer>& bus;
+
+	Sensor sensors[MAX_SENSORS] = {};
+
+	std::size_t sensorCount = 0;
+
+	uint8_t status[MAX_SENSORS] = {};
+
+	uint8_t distances[MAX_SENSORS][2] = {};
+
+	bool singleReadPerTransfer;
+
+	/**
+	 * Queue a read, submitting the queue first if it doesn't fit or a single read per transfer is used
+	 */
+	int read(uint8_t address, uint16_t registerAddress, uint8_t* data, uint8_t length) noexcept {
+		if (this->bus.getFreeMessageCount() < 2) {
+			int result = this->bus.submit();
+			if (result != 0) {
+				return result;
+			}
+		}
+		this->bus.queueRead(address, registerAddress, data, length);
+		return this->singleReadPerTransfer ? this->bus.submit() : 0;
+	}
+
+	/**
+	 * Read the status (and the distance) of all the sensors and fill in the results
+	 */
+	int readSensors(Result* results) noexcept {
+		int result = 0;
+		for (std::size_t i = 0; i < this->sensorCount && result == 0; i++) {
+			result = this->read(this->sensors[i].address, GPIO_TIO_HV_STATUS, &this->status[i], 1);
+			// In batches, the distance is read along with the status (and discarded if not ready)
+			if (result == 0 && !this->singleReadPerTransfer) {
+				result = this->read(
+					this->sensors[i].address,
+					VL53L1_RESULT_FINAL_CROSSTALK_CORRECTED_RANGE_MM_SD0,
+					this->distances[i],
+					2
+				);
+			}
+		}
+		if (result == 0) {
+			result = this->bus.submit();
+		}
+		if (result != 0) {
+			return result;
+		}
+
+		for (std::size_t i = 0; i < this->sensorCount; i++) {
+			results[i].ready = (this->status[i] & 0x01) == this->sensors[i].interruptPolarity;
+			if (!results[i].ready) {
+				continue;
+			}
+			if (this->singleReadPerTransfer) {
+				result = this->read(
+					this->sensors[i].address,
+					VL53L1_RESULT_FINAL_CROSSTALK_CORRECTED_RANGE_MM_SD0,
+					this->distances[i],
+					2
+				);
+				if (result != 0) {
+					return result;
+				}
+			}
+			auto distance = static_cast<uint16_t>((this->distances[i][0] << 8) | this->distances[i][1]);
+			results[i].distance = distance > 4000 ? 16384 : distance;
+		}
+		return 0;
+	}
+};
+
+using VL53L1XBatchPoller = VL53L1XBatchPollerT<>;
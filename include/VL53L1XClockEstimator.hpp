@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Estimator of the actual acquisition time of continuous VL53L1X measurements.
+ *
+ * The sensor produces samples on a fixed grid (the inter-measurement period), but the host only notices them when
+ * polling, i.e. up to a polling interval late. The estimator fits the grid to the detection timestamps:
+ *  - the period is fitted (least squares) over a window of recent samples, starting from the programmed period,
+ *    which tracks the sensor oscillator's drift relative to the host clock;
+ *  - the grid offset is the lower envelope of the detection times, as a sample can't be detected before it's ready.
+ * The returned acquisition time is the middle of the measurement, i.e. half the timing budget before data-ready.
+ *
+ * Typical usage:
+ * ```
+ * VL53L1XClockEstimator estimator(sensor.getMeasurementPeriod(), std::chrono::milliseconds(sensor.getTimingBudgetMs()));
+ * auto sample = sensor.getSample();
+ * auto acquisitionTime = estimator.update(sample.timestamp);
+ * ```
+ *
+ * @note Samples must come from continuous ranging with a constant inter-measurement period; call
+ * VL53L1XClockEstimator::reset() after changing the configuration or restarting the ranging.
+ */
+class VL53L1XClockEstimator {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	/**
+	 * Create a new estimator.
+	 *
+	 * @param nominalPeriod The programmed inter-measurement period (see VL53L1X::getMeasurementPeriod())
+	 * @param timingBudget The timing budget of a single measurement
+	 */
+	VL53L1XClockEstimator(std::chrono::nanoseconds nominalPeriod, std::chrono::nanoseconds timingBudget);
+
+	/**
+	 * Feed a new detection timestamp and get the estimated acquisition time of that sample.
+	 *
+	 * @param detectionTime The time at which the sample was detected as ready (e.g. VL53L1X::Sample::timestamp or
+	 * the time of the interrupt edge)
+	 *
+	 * @return The estimated acquisition time (middle of the measurement)
+	 */
+	Clock::time_point update(Clock::time_point detectionTime);
+
+	/**
+	 * Predict the acquisition time of the next sample.
+	 *
+	 * @return The predicted acquisition time (Clock::time_point() if no samples were fed yet)
+	 */
+	Clock::time_point predictNext() const;
+
+	/**
+	 * Get the currently estimated measurement period, in host time.
+	 *
+	 * @return The estimated period
+	 */
+	std::chrono::nanoseconds getPeriod() const;
+
+	/**
+	 * Forget all the samples, starting over from the nominal period.
+	 */
+	void reset();
+
+private:
+	/**
+	 * Number of recent samples used for the fit
+	 */
+	static constexpr std::size_t WINDOW_SIZE = 64;
+
+	/**
+	 * Minimal number of samples before the period fit replaces the nominal period
+	 */
+	static constexpr std::size_t MIN_FIT_SAMPLES = 8;
+
+	struct Point {
+		/**
+		 * Sample index on the sensor's grid (counting the missed samples)
+		 */
+		int64_t index;
+
+		/**
+		 * Detection time, in ns since the first sample
+		 */
+		int64_t time;
+	};
+
+	const double nominalPeriodNs;
+
+	const int64_t halfTimingBudgetNs;
+
+	Clock::time_point origin;
+
+	std::array<Point, WINDOW_SIZE> window;
+
+	std::size_t count;
+
+	std::size_t head;
+
+	int64_t lastIndex;
+
+	int64_t lastTime;
+
+	double periodNs;
+
+	double offsetNs;
+
+	void fit();
+};
@@ -0,0 +1,326 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Register map, default configuration and timing calculations of the VL53L1X.
+ *
+ * Shared by the VL53L1X and VL53L1XT drivers; free of any dependencies, so that it can be used in header-only builds.
+ */
+struct VL53L1XDefinitions {
+	/**
+	 * The I2C address the sensor answers at after powering on
+	 */
+	static constexpr uint8_t DEFAULT_DEVICE_ADDRESS = 0x29;
+
+	/**
+	 * The value of the model ID register (model ID and module type) of a VL53L1X
+	 */
+	static constexpr uint16_t SENSOR_ID = 0xEACC;
+
+	/**
+	 * Fixed overhead of a measurement not covered by the range timeouts (fitted to ST's timing budget tables)
+	 */
+	static constexpr uint32_t TIMING_GUARD_US = 12000;
+
+	/**
+	 * Shortest timing budget in the medium and long distance modes (ST tunes budgets below 20 ms for the short mode only)
+	 */
+	static constexpr uint16_t MIN_LONG_MODE_TIMING_BUDGET_MS = 20;
+
+	enum RegisterAddresses : uint16_t {
+		SOFT_RESET = 0x0000,
+		I2C_SLAVE_DEVICE_ADDRESS = 0x0001,
+		OSC_MEASURED_FAST_OSC_FREQUENCY = 0x0006,
+		VHV_CONFIG_TIMEOUT_MACROP_LOOP_BOUND = 0x0008,
+		VHV_CONFIG_INIT = 0x000B,
+		ALGO_CROSSTALK_COMPENSATION_PLANE_OFFSET_KCPS = 0x0016,
+		ALGO_CROSSTALK_COMPENSATION_X_PLANE_GRADIENT_KCPS = 0x0018,
+		ALGO_CROSSTALK_COMPENSATION_Y_PLANE_GRADIENT_KCPS = 0x001A,
+		ALGO_PART_TO_PART_RANGE_OFFSET_MM = 0x001E,
+		MM_CONFIG_INNER_OFFSET_MM = 0x0020,
+		MM_CONFIG_OUTER_OFFSET_MM = 0x0022,
+		GPIO_HV_MUX_CTRL = 0x0030,
+		GPIO_TIO_HV_STATUS = 0x0031,
+		SYSTEM_INTERRUPT_CONFIG_GPIO = 0x0046,
+		PHASECAL_CONFIG_TIMEOUT_MACROP = 0x004B,
+		RANGE_CONFIG_TIMEOUT_MACROP_A_HI = 0x005E,
+		RANGE_CONFIG_VCSEL_PERIOD_A = 0x0060,
+		RANGE_CONFIG_VCSEL_PERIOD_B = 0x0063,
+		RANGE_CONFIG_TIMEOUT_MACROP_B_HI = 0x0061,
+		RANGE_CONFIG_TIMEOUT_MACROP_B_LO = 0x0062,
+		RANGE_CONFIG_SIGMA_THRESH = 0x0064,
+		RANGE_CONFIG_MIN_COUNT_RATE_RTN_LIMIT_MCPS = 0x0066,
+		RANGE_CONFIG_VALID_PHASE_HIGH = 0x0069,
+		VL53L1_SYSTEM_INTERMEASUREMENT_PERIOD = 0x006C,
+		SYSTEM_THRESH_HIGH = 0x0072,
+		SYSTEM_THRESH_LOW = 0x0074,
+		SD_CONFIG_WOI_SD0 = 0x0078,
+		SD_CONFIG_INITIAL_PHASE_SD0 = 0x007A,
+		ROI_CONFIG_USER_ROI_CENTRE_SPAD = 0x007F,
+		ROI_CONFIG_USER_ROI_REQUESTED_GLOBAL_XY_SIZE = 0x0080,
+		SYSTEM_SEQUENCE_CONFIG = 0x0081,
+		VL53L1_SYSTEM_GROUPED_PARAMETER_HOLD = 0x0082,
+		SYSTEM_INTERRUPT_CLEAR = 0x0086,
+		SYSTEM_MODE_START = 0x0087,
+		VL53L1_RESULT_RANGE_STATUS = 0x0089,
+		VL53L1_RESULT_DSS_ACTUAL_EFFECTIVE_SPADS_SD0 = 0x008C,
+		RESULT_AMBIENT_COUNT_RATE_MCPS_SD = 0x0090,
+		VL53L1_RESULT_FINAL_CROSSTALK_CORRECTED_RANGE_MM_SD0 = 0x0096,
+		VL53L1_RESULT_PEAK_SIGNAL_COUNT_RATE_CROSSTALK_CORRECTED_MCPS_SD0 = 0x0098,
+		VL53L1_RESULT_OSC_CALIBRATE_VAL = 0x00DE,
+		VL53L1_FIRMWARE_SYSTEM_STATUS = 0x00E5,
+		VL53L1_IDENTIFICATION_MODEL_ID = 0x010F,
+		VL53L1_ROI_CONFIG_MODE_ROI_CENTRE_SPAD = 0x013E,
+	};
+
+	/**
+	 * Default values of the registers 0x2D to 0x87, written on initialization
+	 */
+	static constexpr uint8_t DEFAULT_CONFIGURATION[91] = {
+		0x00, // 0x2d : set bit 2 and 5 to 1 for fast plus mode (1MHz I2C), else don't touch
+		0x00, // 0x2e : bit 0 if I2C pulled up at 1.8V, else set bit 0 to 1 (pull up at AVDD)
+		0x00, // 0x2f : bit 0 if GPIO pulled up at 1.8V, else set bit 0 to 1 (pull up at AVDD)
+		0x01, // 0x30 : set bit 4 to 0 for active high interrupt and 1 for active low (bits 3:0 must be 0x1), use SetInterruptPolarity()
+		0x02, // 0x31 : bit 1 = interrupt depending on the polarity, use CheckForDataReady()
+		0x00, // 0x32 : not user-modifiable
+		0x02, // 0x33 : not user-modifiable
+		0x08, // 0x34 : not user-modifiable
+		0x00, // 0x35 : not user-modifiable
+		0x08, // 0x36 : not user-modifiable
+		0x10, // 0x37 : not user-modifiable
+		0x01, // 0x38 : not user-modifiable
+		0x01, // 0x39 : not user-modifiable
+		0x00, // 0x3a : not user-modifiable
+		0x00, // 0x3b : not user-modifiable
+		0x00, // 0x3c : not user-modifiable
+		0x00, // 0x3d : not user-modifiable
+		0xff, // 0x3e : not user-modifiable
+		0x00, // 0x3f : not user-modifiable
+		0x0F, // 0x40 : not user-modifiable
+		0x00, // 0x41 : not user-modifiable
+		0x00, // 0x42 : not user-modifiable
+		0x00, // 0x43 : not user-modifiable
+		0x00, // 0x44 : not user-modifiable
+		0x00, // 0x45 : not user-modifiable
+		0x20, // 0x46 : interrupt configuration: 0->level low detection, 1-> level high, 2-> Out of window, 3->In window, 0x20-> New sample ready, TBC
+		0x0b, // 0x47 : not user-modifiable
+		0x00, // 0x48 : not user-modifiable
+		0x00, // 0x49 : not user-modifiable
+		0x02, // 0x4a : not user-modifiable
+		0x0a, // 0x4b : not user-modifiable
+		0x21, // 0x4c : not user-modifiable
+		0x00, // 0x4d : not user-modifiable
+		0x00, // 0x4e : not user-modifiable
+		0x05, // 0x4f : not user-modifiable
+		0x00, // 0x50 : not user-modifiable
+		0x00, // 0x51 : not user-modifiable
+		0x00, // 0x52 : not user-modifiable
+		0x00, // 0x53 : not user-modifiable
+		0xc8, // 0x54 : not user-modifiable
+		0x00, // 0x55 : not user-modifiable
+		0x00, // 0x56 : not user-modifiable
+		0x38, // 0x57 : not user-modifiable
+		0xff, // 0x58 : not user-modifiable
+		0x01, // 0x59 : not user-modifiable
+		0x00, // 0x5a : not user-modifiable
+		0x08, // 0x5b : not user-modifiable
+		0x00, // 0x5c : not user-modifiable
+		0x00, // 0x5d : not user-modifiable
+		0x01, // 0x5e : not user-modifiable
+		0xdb, // 0x5f : not user-modifiable
+		0x0f, // 0x60 : not user-modifiable
+		0x01, // 0x61 : not user-modifiable
+		0xf1, // 0x62 : not user-modifiable
+		0x0d, // 0x63 : not user-modifiable
+		0x01, // 0x64 : Sigma threshold MSB (mm in 14.2 format for MSB+LSB), use SetSigmaThreshold(), default value 90 mm
+		0x68, // 0x65 : Sigma threshold LSB
+		0x00, // 0x66 : Min count Rate MSB (MCPS in 9.7 format for MSB+LSB), use SetSignalThreshold()
+		0x80, // 0x67 : Min count Rate LSB
+		0x08, // 0x68 : not user-modifiable
+		0xb8, // 0x69 : not user-modifiable
+		0x00, // 0x6a : not user-modifiable
+		0x00, // 0x6b : not user-modifiable
+		0x00, // 0x6c : interMeasurement period MSB, 32 bits register, use SetIntermeasurementInMs()
+		0x00, // 0x6d : interMeasurement period
+		0x0f, // 0x6e : interMeasurement period
+		0x89, // 0x6f : interMeasurement period LSB
+		0x00, // 0x70 : not user-modifiable
+		0x00, // 0x71 : not user-modifiable
+		0x00, // 0x72 : distance threshold high MSB (in mm, MSB+LSB), use SetD:tanceThreshold()
+		0x00, // 0x73 : distance threshold high LSB
+		0x00, // 0x74 : distance threshold low MSB ( in mm, MSB+LSB), use SetD:tanceThreshold()
+		0x00, // 0x75 : distance threshold low LSB
+		0x00, // 0x76 : not user-modifiable
+		0x01, // 0x77 : not user-modifiable
+		0x0f, // 0x78 : not user-modifiable
+		0x0d, // 0x79 : not user-modifiable
+		0x0e, // 0x7a : not user-modifiable
+		0x0e, // 0x7b : not user-modifiable
+		0x00, // 0x7c : not user-modifiable
+		0x00, // 0x7d : not user-modifiable
+		0x02, // 0x7e : not user-modifiable
+		0xc7, // 0x7f : ROI center, use SetROI()
+		0xff, // 0x80 : XY ROI (X=Width, Y=Height), use SetROI()
+		0x9B, // 0x81 : not user-modifiable
+		0x00, // 0x82 : not user-modifiable
+		0x00, // 0x83 : not user-modifiable
+		0x00, // 0x84 : not user-modifiable
+		0x01, // 0x85 : not user-modifiable
+		0x00, // 0x86 : clear interrupt, use ClearInterrupt()
+		0x00, // 0x87 : start ranging, use StartRanging() or StopRanging(), If you want an automatic start after VL53L1X_init() call, put 0x40 in location 0x87
+	};
+
+	/**
+	 * Register values setting up a distance mode
+	 */
+	struct DistanceModeSettings {
+		uint8_t phasecalTimeout;
+		uint8_t vcselPeriodA;
+		uint8_t vcselPeriodB;
+		uint8_t validPhaseHigh;
+		uint16_t windowOfInterest;
+		uint16_t initialPhase;
+	};
+
+	static constexpr DistanceModeSettings SHORT_MODE_SETTINGS = {0x14, 0x07, 0x05, 0x38, 0x0705, 0x0606};
+
+	/**
+	 * Settings of ST's standard ranging preset
+	 */
+	static constexpr DistanceModeSettings MEDIUM_MODE_SETTINGS = {0x0B, 0x0B, 0x09, 0x78, 0x0B09, 0x0A0A};
+
+	static constexpr DistanceModeSettings LONG_MODE_SETTINGS = {0x0A, 0x0F, 0x0D, 0xB8, 0x0F0D, 0x0E0E};
+
+	/**
+	 * Range timeout register values for a timing budget, as tuned by ST
+	 */
+	struct TimingBudgetSettings {
+		uint16_t timingBudgetMs;
+		uint16_t timeoutA;
+		uint16_t timeoutB;
+	};
+
+	static constexpr TimingBudgetSettings SHORT_MODE_TIMING_BUDGETS[] = {
+		{15, 0x001D, 0x0027},
+		{20, 0x0051, 0x006E},
+		{33, 0x00D6, 0x006E},
+		{50, 0x01AE, 0x01E8},
+		{100, 0x02E1, 0x0388},
+		{200, 0x03E1, 0x0496},
+		{500, 0x0591, 0x05C1},
+	};
+
+	static constexpr TimingBudgetSettings LONG_MODE_TIMING_BUDGETS[] = {
+		{20, 0x001E, 0x0022},
+		{33, 0x0060, 0x006E},
+		{50, 0x00AD, 0x00C6},
+		{100, 0x01CC, 0x01EA},
+		{200, 0x02D9, 0x02F8},
+		{500, 0x048F, 0x04A4},
+	};
+
+	/**
+	 * Find the settings of a timing budget in one of the tables
+	 *
+	 * @param table The table to search (SHORT_MODE_TIMING_BUDGETS or LONG_MODE_TIMING_BUDGETS)
+	 * @param timingBudgetMs The timing budget, in ms
+	 *
+	 * @return The settings, nullptr if not found
+	 */
+	template<std::size_t N>
+	static constexpr const TimingBudgetSettings* findTimingBudget(
+		const TimingBudgetSettings (&table)[N],
+		uint16_t timingBudgetMs
+	) {
+		for (const auto& settings : table) {
+			if (settings.timingBudgetMs == timingBudgetMs) {
+				return &settings;
+			}
+		}
+		return nullptr;
+	}
+
+	/**
+	 * Find the settings matching a range timeout A register value in one of the tables
+	 *
+	 * @param table The table to search (SHORT_MODE_TIMING_BUDGETS or LONG_MODE_TIMING_BUDGETS)
+	 * @param timeoutA The RANGE_CONFIG_TIMEOUT_MACROP_A_HI register value
+	 *
+	 * @return The settings, nullptr if not found
+	 */
+	template<std::size_t N>
+	static constexpr const TimingBudgetSettings* findTimingBudgetByTimeout(
+		const TimingBudgetSettings (&table)[N],
+		uint16_t timeoutA
+	) {
+		for (const auto& settings : table) {
+			if (settings.timeoutA == timeoutA) {
+				return &settings;
+			}
+		}
+		return nullptr;
+	}
+
+	/**
+	 * Calculate the macro period for a VCSEL period register value
+	 *
+	 * @param fastOscFrequency The OSC_MEASURED_FAST_OSC_FREQUENCY register value (MHz, 4.12 format)
+	 * @param vcselPeriod The VCSEL period register value
+	 *
+	 * @return The macro period (us, 12.12 format), 0 if the oscillator frequency is unknown
+	 */
+	static constexpr uint32_t calculateMacroPeriod(uint16_t fastOscFrequency, uint8_t vcselPeriod) {
+		if (fastOscFrequency == 0) {
+			return 0;
+		}
+		// PLL period in 0.24 format (us)
+		uint32_t pllPeriod = (static_cast<uint32_t>(1) << 30) / fastOscFrequency;
+		uint32_t vcselPeriodPclks = (static_cast<uint32_t>(vcselPeriod) + 1) << 1;
+
+		// A macro period is 2304 VCSEL periods
+		uint32_t macroPeriod = 2304 * pllPeriod;
+		macroPeriod >>= 6;
+		macroPeriod *= vcselPeriodPclks;
+		macroPeriod >>= 6;
+		return macroPeriod;
+	}
+
+	/**
+	 * Encode a range timeout into the timeout register format: (LSByte * 2^MSByte) + 1 macro periods
+	 *
+	 * @param timeoutUs The timeout, in us
+	 * @param macroPeriod The macro period, as returned from VL53L1XDefinitions::calculateMacroPeriod()
+	 *
+	 * @return The register value
+	 */
+	static constexpr uint16_t encodeTimeout(uint32_t timeoutUs, uint32_t macroPeriod) {
+		uint32_t timeoutMclks = static_cast<uint32_t>(
+			((static_cast<uint64_t>(timeoutUs) << 12) + (macroPeriod >> 1)) / macroPeriod
+		);
+		if (timeoutMclks == 0) {
+			return 0;
+		}
+		uint32_t lsByte = timeoutMclks - 1;
+		uint16_t msByte = 0;
+		while ((lsByte & 0xFFFFFF00) > 0) {
+			lsByte >>= 1;
+			msByte++;
+		}
+		return static_cast<uint16_t>((msByte << 8) | (lsByte & 0xFF));
+	}
+
+	/**
+	 * Decode a timeout register value
+	 *
+	 * @param value The register value
+	 * @param macroPeriod The macro period, as returned from VL53L1XDefinitions::calculateMacroPeriod()
+	 *
+	 * @return The timeout, in us
+	 */
+	static constexpr uint32_t decodeTimeout(uint16_t value, uint32_t macroPeriod) {
+		uint32_t timeoutMclks = (static_cast<uint32_t>(value & 0xFF) << (value >> 8)) + 1;
+		return static_cast<uint32_t>((static_cast<uint64_t>(timeoutMclks) * macroPeriod + 0x800) >> 12);
+	}
+};
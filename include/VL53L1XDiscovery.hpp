@@ -0,0 +1,166 @@
+#pragma once
+
+#include "VL53L1X.hpp"
+
+#include <GPIOPin.hpp>
+#include <I2CBus.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+/**
+ * Discovery of VL53L1X sensors on an I2C bus and allocation of their addresses.
+ *
+ * Newly powered sensors always answer at the default address (0x29). The discovery powers them on one by one via
+ * their XSHUT pins, verifies the model ID and moves each one to the next free address from the pool.
+ *
+ * @note Sensors that are yet to be added must be held in reset (XSHUT low), so that only one sensor answers at the
+ * default address at a time.
+ */
+class VL53L1XDiscovery {
+public:
+	/**
+	 * A shared_ptr alias (use as VL53L1XDiscovery::SharedPtr)
+	 */
+	using SharedPtr = std::shared_ptr<VL53L1XDiscovery>;
+
+	/**
+	 * A bus along with the XSHUT pins of the sensors connected to it, used in VL53L1XDiscovery::discoverAll()
+	 */
+	struct BusSetup {
+		VL53L1XDiscovery::SharedPtr discovery;
+		std::vector<GPIOPin::SharedPtr> gpioPins;
+	};
+
+	/**
+	 * Create a new discovery instance for a bus.
+	 *
+	 * @param i2cBus The I2C bus to use
+	 * @param addressPool The addresses to assign to the sensors (must not include the default address)
+	 * @param timeout The measurement timeout passed to the created sensors, also limiting their initialization in
+	 * VL53L1XDiscovery::discover() (VL53L1XDiscovery::INITIALIZATION_TIMEOUT is used if 0)
+	 */
+	VL53L1XDiscovery(
+		I2CBus::SharedPtr i2cBus,
+		const std::vector<uint8_t>& addressPool,
+		std::chrono::milliseconds timeout = std::chrono::milliseconds(0)
+	);
+
+	/**
+	 * Probe the bus for VL53L1X sensors.
+	 *
+	 * Reads the model ID register on every address in range; addresses that don't answer or return a different
+	 * model ID are skipped.
+	 *
+	 * @note This writes a register address to every device on the bus, which might confuse non-VL53L1X devices.
+	 *
+	 * @param firstAddress The first address to probe
+	 * @param lastAddress The last address to probe
+	 *
+	 * @return The addresses at which a VL53L1X answers
+	 */
+	std::vector<uint8_t> probe(uint8_t firstAddress = 0x08, uint8_t lastAddress = 0x77);
+
+	/**
+	 * Power on a single new sensor, verify it's a VL53L1X, assign it an address from the pool and initialize it.
+	 *
+	 * @param gpioPin The GPIO pin connected to the sensor's XSHUT pin
+	 *
+	 * @return The initialized sensor, or nullptr if no VL53L1X answered or the address pool is exhausted
+	 */
+	VL53L1X::SharedPtr addSensor(GPIOPin::SharedPtr gpioPin);
+
+	/**
+	 * Power off a sensor and return its address to the pool.
+	 *
+	 * @param sensor The sensor, created by this discovery instance
+	 */
+	void removeSensor(const VL53L1X::SharedPtr& sensor);
+
+	/**
+	 * Power off all the given sensors, then bring them up one by one and assign them addresses.
+	 *
+	 * Unlike calling VL53L1XDiscovery::addSensor() in a loop, the sensors are initialized concurrently.
+	 * The addresses previously assigned to the sensors on these pins are returned to the pool, so the same pins
+	 * can be re-discovered repeatedly.
+	 *
+	 * @note The pins are identified by their instances: rescans must pass the same GPIOPin instances, a new instance
+	 * for the same GPIO line is treated as a new sensor (and the old one's address stays allocated).
+	 *
+	 * @param gpioPins The GPIO pins connected to the sensors' XSHUT pins
+	 *
+	 * @return The initialized sensors; pins with no VL53L1X answering, or not finishing the initialization in time
+	 * (these are powered off), are skipped
+	 */
+	std::vector<VL53L1X::SharedPtr> discover(const std::vector<GPIOPin::SharedPtr>& gpioPins);
+
+	/**
+	 * Run VL53L1XDiscovery::discover() on multiple buses in parallel.
+	 *
+	 * @param buses The buses with their XSHUT pins
+	 *
+	 * @return The initialized sensors, in the same order as the buses
+	 */
+	static std::vector<std::vector<VL53L1X::SharedPtr>> discoverAll(const std::vector<VL53L1XDiscovery::BusSetup>& buses);
+
+	/**
+	 * Create a SharedPtr instance of the VL53L1XDiscovery.
+	 *
+	 * Usage: `VL53L1XDiscovery::makeShared(args...)`.
+	 * See constructor (@ref VL53L1XDiscovery::VL53L1XDiscovery()) for details.
+	 */
+	template<typename ... Args>
+	static VL53L1XDiscovery::SharedPtr makeShared(Args&& ... args) {
+		return std::make_shared<VL53L1XDiscovery>(std::forward<Args>(args) ...);
+	}
+
+private:
+	/**
+	 * Limit for the initialization in VL53L1XDiscovery::discover() if no timeout is set
+	 */
+	static constexpr std::chrono::milliseconds INITIALIZATION_TIMEOUT = std::chrono::milliseconds(1000);
+
+	I2CBus::SharedPtr i2cBus;
+
+	const std::chrono::milliseconds timeout;
+
+	/**
+	 * Addresses yet to be assigned
+	 */
+	std::set<uint8_t> freeAddresses;
+
+	/**
+	 * Addresses assigned by this instance, by the XSHUT pin of the sensor (holding the pins, so that a destroyed pin's
+	 * address can't be mistaken for a new one)
+	 */
+	std::map<GPIOPin::SharedPtr, uint8_t> assignedAddresses;
+
+	/**
+	 * Check whether a VL53L1X answers at the given address
+	 */
+	bool isSensorAt(uint8_t address);
+
+	/**
+	 * Check whether any device answers at the given address
+	 */
+	bool isAddressUsed(uint8_t address);
+
+	/**
+	 * Take the first free address that no device answers at (0 if none is available)
+	 */
+	uint8_t allocateAddress();
+
+	/**
+	 * Return the address assigned to the sensor on the given pin (if any) to the pool
+	 */
+	void releaseAddress(const GPIOPin::SharedPtr& gpioPin);
+
+	/**
+	 * Power on a sensor and move it to a newly allocated address, without initializing it
+	 */
+	VL53L1X::SharedPtr bringUp(GPIOPin::SharedPtr gpioPin);
+};
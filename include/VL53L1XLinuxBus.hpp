@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#include <fcntl.h>
+#include <linux/i2c-dev.h>
+#include <linux/i2c.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+/**
+ * Minimal i2c-dev bus policy for VL53L1XT: no exceptions, no allocations.
+ *
+ * Every register access is a single I2C_RDWR ioctl (register address write + data read for reads).
+ * All the methods return 0 on success or a negative errno value on failure.
+ */
+class VL53L1XLinuxBus {
+public:
+	/**
+	 * Maximal number of data bytes in a single write
+	 */
+	static constexpr uint8_t MAX_WRITE_LENGTH = 128;
+
+	VL53L1XLinuxBus() noexcept = default;
+
+	VL53L1XLinuxBus(const VL53L1XLinuxBus&) = delete;
+
+	VL53L1XLinuxBus& operator=(const VL53L1XLinuxBus&) = delete;
+
+	~VL53L1XLinuxBus() {
+		this->close();
+	}
+
+	/**
+	 * Open the bus device.
+	 *
+	 * @param path The path to the bus device, e.g. "/dev/i2c-1"
+	 *
+	 * @return 0 or a negative errno value
+	 */
+	int open(const char* path) noexcept {
+		this->close();
+		this->fd = ::open(path, O_RDWR);
+		return this->fd < 0 ? -errno : 0;
+	}
+
+	/**
+	 * Close the bus device (does nothing if not open).
+	 */
+	void close() noexcept {
+		if (this->fd >= 0) {
+			::close(this->fd);
+			this->fd = -1;
+		}
+	}
+
+	/**
+	 * Read consecutive registers.
+	 *
+	 * @param deviceAddress The I2C address of the device
+	 * @param registerAddress The (16-bit) address of the first register
+	 * @param data The buffer for the data
+	 * @param length The number of bytes to read
+	 *
+	 * @return 0 or a negative errno value
+	 */
+	int readRegister(uint8_t deviceAddress, uint16_t registerAddress, uint8_t* data, uint8_t length) noexcept {
+		uint8_t registerBuffer[2] = {static_cast<uint8_t>(registerAddress >> 8), static_cast<uint8_t>(registerAddress)};
+		i2c_msg messages[2] = {
+			{deviceAddress, 0, 2, registerBuffer},
+			{deviceAddress, I2C_M_RD, length, data},
+		};
+		i2c_rdwr_ioctl_data transfer = {messages, 2};
+		return ::ioctl(this->fd, I2C_RDWR, &transfer) < 0 ? -errno : 0;
+	}
+
+	/**
+	 * Write consecutive registers.
+	 *
+	 * @param deviceAddress The I2C address of the device
+	 * @param registerAddress The (16-bit) address of the first register
+	 * @param data The data to write
+	 * @param length The number of bytes to write (up to VL53L1XLinuxBus::MAX_WRITE_LENGTH)
+	 *
+	 * @return 0 or a negative errno value
+	 */
+	int writeRegister(uint8_t deviceAddress, uint16_t registerAddress, const uint8_t* data, uint8_t length) noexcept {
+		if (length > VL53L1XLinuxBus::MAX_WRITE_LENGTH) {
+			return -EINVAL;
+		}
+		uint8_t buffer[2 + VL53L1XLinuxBus::MAX_WRITE_LENGTH];
+		buffer[0] = static_cast<uint8_t>(registerAddress >> 8);
+		buffer[1] = static_cast<uint8_t>(registerAddress);
+		std::memcpy(&buffer[2], data, length);
+
+		i2c_msg message = {deviceAddress, 0, static_cast<uint16_t>(2 + length), buffer};
+		i2c_rdwr_ioctl_data transfer = {&message, 1};
+		return ::ioctl(this->fd, I2C_RDWR, &transfer) < 0 ? -errno : 0;
+	}
+
+private:
+	int fd = -1;
+};
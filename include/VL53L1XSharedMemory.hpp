@@ -0,0 +1,205 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * Layout of the POSIX shared memory segment written by VL53L1XSharedMemoryPublisher.
+ *
+ * The segment is a header followed by one slot per sensor, each on its own cache line(s).
+ * A slot is guarded by a sequence lock: the writer makes the sequence odd while updating the slot,
+ * readers retry until they see the same, even sequence before and after reading it.
+ */
+struct VL53L1XSharedMemoryLayout {
+	static constexpr uint32_t MAGIC = 0x58314C56; // "VL1X"
+
+	static constexpr uint32_t VERSION = 1;
+
+	static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+	struct alignas(CACHE_LINE_SIZE) Header {
+		std::atomic<uint32_t> magic;
+		uint32_t version;
+		uint32_t sensorCount;
+	};
+
+	struct alignas(CACHE_LINE_SIZE) Slot {
+		std::atomic<uint32_t> sequence;
+
+		/**
+		 * Number of samples published so far
+		 */
+		std::atomic<uint32_t> sampleCount;
+
+		/**
+		 * Incremented by the sensor on every configuration change (see VL53L1X::getConfigurationEpoch())
+		 */
+		std::atomic<uint32_t> configurationEpoch;
+
+		/**
+		 * Distance in mm (special values as in VL53L1X::getDistance())
+		 */
+		std::atomic<uint16_t> distance;
+
+		/**
+		 * Data-ready detection time, steady_clock (CLOCK_MONOTONIC) nanoseconds - comparable between processes
+		 */
+		std::atomic<int64_t> timestampNs;
+	};
+
+	static_assert(std::atomic<uint32_t>::is_always_lock_free, "Lock-free atomics are required in shared memory");
+	static_assert(std::atomic<int64_t>::is_always_lock_free, "Lock-free atomics are required in shared memory");
+
+	/**
+	 * Size of the segment for a given number of sensors
+	 */
+	static constexpr std::size_t size(std::size_t sensorCount) {
+		return sizeof(Header) + sensorCount * sizeof(Slot);
+	}
+};
+
+/**
+ * Reader of the samples published by VL53L1XSharedMemoryPublisher from another process.
+ *
+ * Header-only, with no dependencies (link with `rt` on older glibc versions).
+ * After opening, reading a sample involves no syscalls - just the sensor's cache line.
+ */
+class VL53L1XSharedMemoryReader {
+public:
+	/**
+	 * A consistent copy of a sensor's latest sample
+	 */
+	struct Snapshot {
+		uint16_t distance;
+		std::chrono::steady_clock::time_point timestamp;
+		uint32_t configurationEpoch;
+		uint32_t sampleCount;
+	};
+
+	/**
+	 * Maximal number of attempts to get a consistent copy of a slot in VL53L1XSharedMemoryReader::read()
+	 *
+	 * A slot stays locked forever if the publisher dies in the middle of an update; an update itself takes well
+	 * under a microsecond, so running out of the attempts means the publisher is dead (or stalled mid-update).
+	 */
+	static constexpr uint32_t MAX_READ_ATTEMPTS = 100000;
+
+	VL53L1XSharedMemoryReader() noexcept = default;
+
+	VL53L1XSharedMemoryReader(const VL53L1XSharedMemoryReader&) = delete;
+
+	VL53L1XSharedMemoryReader& operator=(const VL53L1XSharedMemoryReader&) = delete;
+
+	~VL53L1XSharedMemoryReader() {
+		this->close();
+	}
+
+	/**
+	 * Map the segment created by the publisher.
+	 *
+	 * @param name The segment name, as passed to the publisher (e.g. "/vl53l1x")
+	 *
+	 * @return True on success; false if the segment doesn't exist (yet) or is not a valid one
+	 */
+	bool open(const char* name) noexcept {
+		this->close();
+		int fd = ::shm_open(name, O_RDONLY, 0);
+		if (fd < 0) {
+			return false;
+		}
+		struct stat status = {};
+		if (::fstat(fd, &status) != 0 || static_cast<std::size_t>(status.st_size) < VL53L1XSharedMemoryLayout::size(0)) {
+			::close(fd);
+			return false;
+		}
+		auto mappingSize = static_cast<std::size_t>(status.st_size);
+		void* mapping = ::mmap(nullptr, mappingSize, PROT_READ, MAP_SHARED, fd, 0);
+		::close(fd);
+		if (mapping == MAP_FAILED) {
+			return false;
+		}
+
+		const auto* header = static_cast<const VL53L1XSharedMemoryLayout::Header*>(mapping);
+		if (header->magic.load(std::memory_order_acquire) != VL53L1XSharedMemoryLayout::MAGIC
+			|| header->version != VL53L1XSharedMemoryLayout::VERSION
+			|| VL53L1XSharedMemoryLayout::size(header->sensorCount) > mappingSize) {
+			::munmap(mapping, mappingSize);
+			return false;
+		}
+
+		this->mapping = mapping;
+		this->mappingSize = mappingSize;
+		this->sensorCount = header->sensorCount;
+		this->slots = reinterpret_cast<const VL53L1XSharedMemoryLayout::Slot*>(header + 1);
+		return true;
+	}
+
+	/**
+	 * Unmap the segment (does nothing if not open).
+	 */
+	void close() noexcept {
+		if (this->mapping != nullptr) {
+			::munmap(this->mapping, this->mappingSize);
+		}
+		this->mapping = nullptr;
+		this->mappingSize = 0;
+		this->sensorCount = 0;
+		this->slots = nullptr;
+	}
+
+	/**
+	 * Get the number of sensors in the segment.
+	 */
+	std::size_t getSensorCount() const noexcept {
+		return this->sensorCount;
+	}
+
+	/**
+	 * Read the latest sample of a sensor.
+	 *
+	 * @param index The sensor index, as used by the publisher
+	 * @param snapshot The read sample
+	 *
+	 * @return False if the index is invalid, no sample was published yet or the slot stayed locked for
+	 * VL53L1XSharedMemoryReader::MAX_READ_ATTEMPTS attempts (e.g. the publisher died while updating it)
+	 */
+	bool read(std::size_t index, Snapshot& snapshot) const noexcept {
+		if (index >= this->sensorCount) {
+			return false;
+		}
+		const VL53L1XSharedMemoryLayout::Slot& slot = this->slots[index];
+		for (uint32_t attempt = 0; attempt < VL53L1XSharedMemoryReader::MAX_READ_ATTEMPTS; attempt++) {
+			uint32_t sequenceBefore = slot.sequence.load(std::memory_order_acquire);
+			if (sequenceBefore & 1) {
+				// Being written right now
+				continue;
+			}
+			snapshot.sampleCount = slot.sampleCount.load(std::memory_order_relaxed);
+			snapshot.configurationEpoch = slot.configurationEpoch.load(std::memory_order_relaxed);
+			snapshot.distance = slot.distance.load(std::memory_order_relaxed);
+			int64_t timestampNs = slot.timestampNs.load(std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (slot.sequence.load(std::memory_order_relaxed) == sequenceBefore) {
+				snapshot.timestamp = std::chrono::steady_clock::time_point(std::chrono::nanoseconds(timestampNs));
+				return snapshot.sampleCount != 0;
+			}
+		}
+		return false;
+	}
+
+private:
+	void* mapping = nullptr;
+
+	std::size_t mappingSize = 0;
+
+	std::size_t sensorCount = 0;
+
+	const VL53L1XSharedMemoryLayout::Slot* slots = nullptr;
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "VL53L1X.hpp"
+#include "VL53L1XSharedMemory.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * Publisher of the latest samples of multiple sensors into a POSIX shared memory segment.
+ *
+ * Other processes read the samples with VL53L1XSharedMemoryReader, without any syscalls or locking.
+ * Only a single process (and thread) may publish into a segment.
+ */
+class VL53L1XSharedMemoryPublisher {
+public:
+	/**
+	 * A shared_ptr alias (use as VL53L1XSharedMemoryPublisher::SharedPtr)
+	 */
+	using SharedPtr = std::shared_ptr<VL53L1XSharedMemoryPublisher>;
+
+	/**
+	 * Create (or re-create) the shared memory segment.
+	 *
+	 * @param name The segment name, e.g. "/vl53l1x"
+	 * @param sensorCount The number of sensors to publish
+	 *
+	 * @throws std::system_error if the segment can't be created
+	 */
+	VL53L1XSharedMemoryPublisher(std::string name, std::size_t sensorCount);
+
+	VL53L1XSharedMemoryPublisher(const VL53L1XSharedMemoryPublisher&) = delete;
+
+	VL53L1XSharedMemoryPublisher& operator=(const VL53L1XSharedMemoryPublisher&) = delete;
+
+	/**
+	 * Unmap and remove the segment (readers which have it mapped can still access it).
+	 */
+	~VL53L1XSharedMemoryPublisher();
+
+	/**
+	 * Publish a sensor's sample.
+	 *
+	 * @param index The sensor index (0 ~ sensorCount - 1)
+	 * @param sample The sample
+	 * @param configurationEpoch The sensor's configuration epoch (see VL53L1X::getConfigurationEpoch())
+	 */
+	void publish(std::size_t index, const VL53L1X::Sample& sample, uint32_t configurationEpoch);
+
+	/**
+	 * Create a SharedPtr instance of the VL53L1XSharedMemoryPublisher.
+	 *
+	 * Usage: `VL53L1XSharedMemoryPublisher::makeShared(args...)`.
+	 * See constructor (@ref VL53L1XSharedMemoryPublisher::VL53L1XSharedMemoryPublisher()) for details.
+	 */
+	template<typename ... Args>
+	static VL53L1XSharedMemoryPublisher::SharedPtr makeShared(Args&& ... args) {
+		return std::make_shared<VL53L1XSharedMemoryPublisher>(std::forward<Args>(args) ...);
+	}
+
+private:
+	const std::string name;
+
+	const std::size_t sensorCount;
+
+	const std::size_t mappingSize;
+
+	void* mapping;
+
+	VL53L1XSharedMemoryLayout::Slot* slots;
+};
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "VL53L1X.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * Health supervisor for a set of VL53L1X sensors.
+ *
+ * Detects sensors that stopped producing samples or whose bus accesses throw, then recovers them by power-cycling
+ * via XSHUT, re-assigning the address, re-initializing and restoring the cached configuration.
+ * Recovery is performed as a non-blocking state machine stepped from VL53L1XSupervisor::poll(), so the remaining
+ * sensors keep being read while one of them is being recovered.
+ *
+ * @note Sensors must be initialized and ranging before being added.
+ * @note While a sensor is being recovered it answers at the default address (0x29) - no other sensor may use it.
+ */
+class VL53L1XSupervisor {
+public:
+	/**
+	 * A shared_ptr alias (use as VL53L1XSupervisor::SharedPtr)
+	 */
+	using SharedPtr = std::shared_ptr<VL53L1XSupervisor>;
+
+	/**
+	 * Per-sensor recovery statistics
+	 */
+	struct RecoveryMetrics {
+		/**
+		 * Number of detected faults (timeouts and bus errors)
+		 */
+		uint32_t faults = 0;
+
+		/**
+		 * Number of successfully finished recoveries
+		 */
+		uint32_t recoveries = 0;
+
+		/**
+		 * Number of recovery attempts that failed (bus error or timeout) and had to be restarted
+		 */
+		uint32_t failedAttempts = 0;
+
+		/**
+		 * Time from starting the recovery to restoring the ranging, for the last recovery
+		 */
+		std::chrono::microseconds lastLatency = std::chrono::microseconds(0);
+
+		/**
+		 * Longest recovery time so far
+		 */
+		std::chrono::microseconds maxLatency = std::chrono::microseconds(0);
+
+		/**
+		 * Sum of all recovery times (divide by `recoveries` to get the mean)
+		 */
+		std::chrono::microseconds totalLatency = std::chrono::microseconds(0);
+	};
+
+	/**
+	 * Create a new supervisor.
+	 *
+	 * @param faultThreshold The number of consecutive faults after which a sensor is recovered
+	 * @param sampleTimeout The time without a new sample after which a fault is registered
+	 * @param recoveryTimeout The time after which a single recovery attempt is abandoned and restarted
+	 */
+	explicit VL53L1XSupervisor(
+		uint8_t faultThreshold = 3,
+		std::chrono::milliseconds sampleTimeout = std::chrono::milliseconds(1000),
+		std::chrono::milliseconds recoveryTimeout = std::chrono::milliseconds(1000)
+	);
+
+	/**
+	 * Add a sensor to be supervised.
+	 *
+	 * @param sensor The sensor (initialized and ranging)
+	 *
+	 * @return The index of the sensor, to be used in the getters
+	 */
+	std::size_t addSensor(VL53L1X::SharedPtr sensor);
+
+	/**
+	 * Poll all the sensors once: read the new samples, detect faults and advance the running recoveries.
+	 *
+	 * Does not block waiting for the data - should be called periodically, at least as often as the sensors' period.
+	 */
+	void poll();
+
+	/**
+	 * Get the latest distance measured by a sensor, in mm.
+	 *
+	 * @param index The sensor index, as returned from VL53L1XSupervisor::addSensor()
+	 *
+	 * @return The distance, or 65535 if the sensor is faulty or has not produced a sample yet
+	 */
+	uint16_t getDistance(std::size_t index) const;
+
+	/**
+	 * Check whether a sensor is working normally (i.e. is not being recovered).
+	 *
+	 * @param index The sensor index, as returned from VL53L1XSupervisor::addSensor()
+	 *
+	 * @return True if the sensor is healthy
+	 */
+	bool isHealthy(std::size_t index) const;
+
+	/**
+	 * Get the recovery statistics of a sensor.
+	 *
+	 * @param index The sensor index, as returned from VL53L1XSupervisor::addSensor()
+	 *
+	 * @return The recovery metrics
+	 */
+	VL53L1XSupervisor::RecoveryMetrics getRecoveryMetrics(std::size_t index) const;
+
+	/**
+	 * Create a SharedPtr instance of the VL53L1XSupervisor.
+	 *
+	 * Usage: `VL53L1XSupervisor::makeShared(args...)`.
+	 * See constructor (@ref VL53L1XSupervisor::VL53L1XSupervisor()) for details.
+	 */
+	template<typename ... Args>
+	static VL53L1XSupervisor::SharedPtr makeShared(Args&& ... args) {
+		return std::make_shared<VL53L1XSupervisor>(std::forward<Args>(args) ...);
+	}
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	enum class State : uint8_t {
+		HEALTHY,
+		FAULTED,
+		POWERED_OFF,
+		INITIALIZING
+	};
+
+	struct SupervisedSensor {
+		VL53L1X::SharedPtr sensor;
+		State state = State::HEALTHY;
+		uint8_t consecutiveFaults = 0;
+		uint16_t distance = 65535;
+		Clock::time_point lastSampleTime;
+		Clock::time_point recoveryStartTime;
+		Clock::time_point stateEntryTime;
+		RecoveryMetrics metrics;
+	};
+
+	const uint8_t faultThreshold;
+
+	const std::chrono::milliseconds sampleTimeout;
+
+	const std::chrono::milliseconds recoveryTimeout;
+
+	std::vector<SupervisedSensor> sensors;
+
+	void step(SupervisedSensor& entry, Clock::time_point now);
+
+	void handleFault(SupervisedSensor& entry, Clock::time_point now);
+
+	void finishRecovery(SupervisedSensor& entry, Clock::time_point now);
+};
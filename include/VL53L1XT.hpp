@@ -0,0 +1,386 @@
+#pragma once
+
+#include "VL53L1XDefinitions.hpp"
+
+#include <cstdint>
+
+/**
+ * Header-only VL53L1X driver for real-time and embedded use: no exceptions, no allocations, no sleeping.
+ *
+ * The bus is a policy type, taken by reference, so that the register access can be inlined. It must provide:
+ * ```
+ * int readRegister(uint8_t deviceAddress, uint16_t registerAddress, uint8_t* data, uint8_t length) noexcept;
+ * int writeRegister(uint8_t deviceAddress, uint16_t registerAddress, const uint8_t* data, uint8_t length) noexcept;
+ * ```
+ * both returning 0 on success (see VL53L1XLinuxBus for an i2c-dev implementation).
+ *
+ * All the methods return a VL53L1XT::Status; the results are returned via reference arguments.
+ * Unlike VL53L1X, nothing blocks waiting for the data - poll VL53L1XT::isDataReady() instead.
+ *
+ * @note Not thread-safe; use one instance from a single thread (or guard it externally).
+ */
+template<typename Bus>
+class VL53L1XT: private VL53L1XDefinitions {
+public:
+	/**
+	 * Result of an operation
+	 */
+	enum class Status : uint8_t {
+		OK,
+		BUS_ERROR,
+		TIMEOUT,
+		INVALID_ARGUMENT
+	};
+
+	/**
+	 * Available distance measuring modes, used in VL53L1XT::setDistanceMode()
+	 */
+	enum class DistanceMode : uint8_t {
+		SHORT,
+		MEDIUM,
+		LONG
+	};
+
+	/**
+	 * The I2C address the sensor answers at after powering on
+	 */
+	using VL53L1XDefinitions::DEFAULT_DEVICE_ADDRESS;
+
+	/**
+	 * The value of the model ID register (model ID and module type) of a VL53L1X
+	 */
+	using VL53L1XDefinitions::SENSOR_ID;
+
+	/**
+	 * Create a new VL53L1X sensor instance.
+	 *
+	 * @param bus The bus to use (must outlive the sensor)
+	 * @param address The sensor's address (only needed if already set to other than the default)
+	 */
+	explicit VL53L1XT(Bus& bus, uint8_t address = VL53L1XT::DEFAULT_DEVICE_ADDRESS) noexcept:
+		bus(bus),
+		address(address) {}
+
+	/**
+	 * Initialize the sensor, busy-polling for the initial measurement.
+	 *
+	 * @param maxPolls The maximal number of data-ready polls before giving up
+	 *
+	 * @return Status::TIMEOUT if the initial measurement didn't finish in time
+	 */
+	Status initialize(uint32_t maxPolls = 100000) noexcept {
+		// Write the whole default configuration (registers 0x2D to 0x87) in a single transaction
+		Status status = this->writeRegisters(0x2D, VL53L1XT::DEFAULT_CONFIGURATION, sizeof(VL53L1XT::DEFAULT_CONFIGURATION));
+		if (status == Status::OK) {
+			status = this->write8(SYSTEM_MODE_START, 0x40);
+		}
+		bool ready = false;
+		for (uint32_t i = 0; status == Status::OK && !ready; i++) {
+			if (i == maxPolls) {
+				return Status::TIMEOUT;
+			}
+			status = this->isDataReady(ready);
+		}
+		if (status == Status::OK) {
+			status = this->clearInterrupt();
+		}
+		if (status == Status::OK) {
+			status = this->stopRanging();
+		}
+		// two bounds VHV
+		if (status == Status::OK) {
+			status = this->write8(VHV_CONFIG_TIMEOUT_MACROP_LOOP_BOUND, 0x09);
+		}
+		if (status == Status::OK) {
+			status = this->write8(VHV_CONFIG_INIT, 0);
+		}
+		uint8_t muxControl = 0;
+		if (status == Status::OK) {
+			status = this->read8(GPIO_HV_MUX_CTRL, muxControl);
+		}
+		this->interruptPolarity = !((muxControl & 0x10) >> 4);
+		return status;
+	}
+
+	/**
+	 * Change sensor's I2C address (sets both the address on the physical sensor and within sensor's object).
+	 */
+	Status setAddress(uint8_t newAddress) noexcept {
+		Status status = this->write8(I2C_SLAVE_DEVICE_ADDRESS, newAddress & 0x7F);
+		if (status == Status::OK) {
+			this->address = newAddress;
+		}
+		return status;
+	}
+
+	/**
+	 * Get the sensor's I2C address, as known by this object.
+	 */
+	uint8_t getAddress() const noexcept {
+		return this->address;
+	}
+
+	/**
+	 * Get the level of the GPIO1 interrupt signalling new data (read by VL53L1XT::initialize()).
+	 */
+	uint8_t getInterruptPolarity() const noexcept {
+		return this->interruptPolarity;
+	}
+
+	/**
+	 * Read the sensor's model ID and module type (VL53L1XT::SENSOR_ID for a VL53L1X)
+	 */
+	Status getSensorId(uint16_t& sensorId) noexcept {
+		return this->read16(VL53L1_IDENTIFICATION_MODEL_ID, sensorId);
+	}
+
+	/**
+	 * Start the continuous ranging operation
+	 */
+	Status startRanging() noexcept {
+		return this->write8(SYSTEM_MODE_START, 0x40);
+	}
+
+	/**
+	 * Stop the ranging operation
+	 */
+	Status stopRanging() noexcept {
+		return this->write8(SYSTEM_MODE_START, 0x00);
+	}
+
+	/**
+	 * Clear the interrupt flag of the sensor
+	 */
+	Status clearInterrupt() noexcept {
+		return this->write8(SYSTEM_INTERRUPT_CLEAR, 0x01);
+	}
+
+	/**
+	 * Check whether the distance data is ready
+	 */
+	Status isDataReady(bool& ready) noexcept {
+		uint8_t value = 0;
+		Status status = this->read8(GPIO_TIO_HV_STATUS, value);
+		ready = (status == Status::OK) && (value & 0x01) == this->interruptPolarity;
+		return status;
+	}
+
+	/**
+	 * Read the measured distance (in mm) and clear the interrupt, without checking whether the data is ready.
+	 *
+	 * The distance is 16384 for an out-of-range measurement (>4m).
+	 */
+	Status readDistance(uint16_t& distance) noexcept {
+		Status status = this->read16(VL53L1_RESULT_FINAL_CROSSTALK_CORRECTED_RANGE_MM_SD0, distance);
+		if (status != Status::OK) {
+			return status;
+		}
+		if (distance > 4000) {
+			distance = 16384;
+		}
+		return this->clearInterrupt();
+	}
+
+	/**
+	 * Set the distance mode, long: 0~4m, medium: 0~3m, short: 0~1.3m
+	 *
+	 * The timing budget set with VL53L1XT::setTimingBudget() (if any) is re-applied.
+	 */
+	Status setDistanceMode(DistanceMode mode) noexcept {
+		const DistanceModeSettings& settings = (mode == DistanceMode::SHORT) ? VL53L1XT::SHORT_MODE_SETTINGS
+			: (mode == DistanceMode::MEDIUM) ? VL53L1XT::MEDIUM_MODE_SETTINGS
+			: VL53L1XT::LONG_MODE_SETTINGS;
+
+		Status status = this->write8(PHASECAL_CONFIG_TIMEOUT_MACROP, settings.phasecalTimeout);
+		if (status == Status::OK) {
+			status = this->write8(RANGE_CONFIG_VCSEL_PERIOD_A, settings.vcselPeriodA);
+		}
+		if (status == Status::OK) {
+			status = this->write8(RANGE_CONFIG_VCSEL_PERIOD_B, settings.vcselPeriodB);
+		}
+		if (status == Status::OK) {
+			status = this->write8(RANGE_CONFIG_VALID_PHASE_HIGH, settings.validPhaseHigh);
+		}
+		if (status == Status::OK) {
+			status = this->write16(SD_CONFIG_WOI_SD0, settings.windowOfInterest);
+		}
+		if (status == Status::OK) {
+			status = this->write16(SD_CONFIG_INITIAL_PHASE_SD0, settings.initialPhase);
+		}
+		if (status != Status::OK) {
+			return status;
+		}
+		this->distanceMode = mode;
+		if (this->timingBudgetMs != 0) {
+			// Budgets below 20 ms only exist in the short mode
+			if (mode != DistanceMode::SHORT && this->timingBudgetMs < VL53L1XT::MIN_LONG_MODE_TIMING_BUDGET_MS) {
+				return this->setTimingBudget(VL53L1XT::MIN_LONG_MODE_TIMING_BUDGET_MS);
+			}
+			return this->setTimingBudget(this->timingBudgetMs);
+		}
+		return Status::OK;
+	}
+
+	/**
+	 * Set the timing budget, in ms
+	 *
+	 * Uses ST's tuned values where available (as VL53L1X::setTimingBudgetMs()), otherwise calculates the timeouts.
+	 *
+	 * @param timingBudgetMs The timing budget (range: 13 ~ 1112 in the short mode, 20 ~ 1112 in the others)
+	 */
+	Status setTimingBudget(uint16_t timingBudgetMs) noexcept {
+		if (this->distanceMode != DistanceMode::SHORT && timingBudgetMs < VL53L1XT::MIN_LONG_MODE_TIMING_BUDGET_MS) {
+			return Status::INVALID_ARGUMENT;
+		}
+		const TimingBudgetSettings* settings = nullptr;
+		if (this->distanceMode == DistanceMode::SHORT) {
+			settings = VL53L1XT::findTimingBudget(VL53L1XT::SHORT_MODE_TIMING_BUDGETS, timingBudgetMs);
+		} else if (this->distanceMode == DistanceMode::LONG) {
+			settings = VL53L1XT::findTimingBudget(VL53L1XT::LONG_MODE_TIMING_BUDGETS, timingBudgetMs);
+		}
+
+		uint16_t timeoutA = 0;
+		uint16_t timeoutB = 0;
+		if (settings != nullptr) {
+			timeoutA = settings->timeoutA;
+			timeoutB = settings->timeoutB;
+		} else {
+			uint32_t timingBudgetUs = static_cast<uint32_t>(timingBudgetMs) * 1000;
+			if (timingBudgetUs <= VL53L1XT::TIMING_GUARD_US || timingBudgetUs - VL53L1XT::TIMING_GUARD_US > 1100000) {
+				return Status::INVALID_ARGUMENT;
+			}
+			uint32_t rangeTimeoutUs = (timingBudgetUs - VL53L1XT::TIMING_GUARD_US) / 2;
+
+			uint16_t fastOscFrequency = 0;
+			uint8_t vcselPeriodA = 0;
+			uint8_t vcselPeriodB = 0;
+			Status status = this->read16(OSC_MEASURED_FAST_OSC_FREQUENCY, fastOscFrequency);
+			if (status == Status::OK) {
+				status = this->read8(RANGE_CONFIG_VCSEL_PERIOD_A, vcselPeriodA);
+			}
+			if (status == Status::OK) {
+				status = this->read8(RANGE_CONFIG_VCSEL_PERIOD_B, vcselPeriodB);
+			}
+			if (status != Status::OK) {
+				return status;
+			}
+			uint32_t macroPeriodA = VL53L1XT::calculateMacroPeriod(fastOscFrequency, vcselPeriodA);
+			uint32_t macroPeriodB = VL53L1XT::calculateMacroPeriod(fastOscFrequency, vcselPeriodB);
+			if (macroPeriodA == 0 || macroPeriodB == 0) {
+				return Status::BUS_ERROR;
+			}
+			timeoutA = VL53L1XT::encodeTimeout(rangeTimeoutUs, macroPeriodA);
+			timeoutB = VL53L1XT::encodeTimeout(rangeTimeoutUs, macroPeriodB);
+		}
+
+		Status status = this->write16(RANGE_CONFIG_TIMEOUT_MACROP_A_HI, timeoutA);
+		if (status == Status::OK) {
+			status = this->write16(RANGE_CONFIG_TIMEOUT_MACROP_B_HI, timeoutB);
+		}
+		if (status == Status::OK) {
+			this->timingBudgetMs = timingBudgetMs;
+		}
+		return status;
+	}
+
+	/**
+	 * Set the inter-measurement period (IMP) in ms
+	 *
+	 * @param period must be greater than or equal to the timing budget range (0 ~ 1693)
+	 */
+	Status setInterMeasurementPeriod(uint16_t period) noexcept {
+		uint16_t clockPLL = 0;
+		Status status = this->read16(VL53L1_RESULT_OSC_CALIBRATE_VAL, clockPLL);
+		if (status != Status::OK) {
+			return status;
+		}
+		clockPLL &= 0x03FF;
+		return this->write32(VL53L1_SYSTEM_INTERMEASUREMENT_PERIOD, static_cast<uint32_t>(clockPLL) * period * 1075 / 1000);
+	}
+
+	/**
+	 * Apply the correction offset value (in millimeters) to the sensor (range: -1024 ~ 1023)
+	 */
+	Status setOffset(int16_t offsetValue) noexcept {
+		Status status = this->write16(ALGO_PART_TO_PART_RANGE_OFFSET_MM, static_cast<uint16_t>(offsetValue * 4));
+		if (status == Status::OK) {
+			status = this->write16(MM_CONFIG_INNER_OFFSET_MM, 0x0);
+		}
+		if (status == Status::OK) {
+			status = this->write16(MM_CONFIG_OUTER_OFFSET_MM, 0x0);
+		}
+		return status;
+	}
+
+	/**
+	 * Apply the crosstalk value (in counts per second) to the sensor
+	 */
+	Status setCrosstalk(uint16_t crosstalkValue) noexcept {
+		Status status = this->write16(ALGO_CROSSTALK_COMPENSATION_X_PLANE_GRADIENT_KCPS, 0x0000);
+		if (status == Status::OK) {
+			status = this->write16(ALGO_CROSSTALK_COMPENSATION_Y_PLANE_GRADIENT_KCPS, 0x0000);
+		}
+		if (status == Status::OK) {
+			status = this->write16(ALGO_CROSSTALK_COMPENSATION_PLANE_OFFSET_KCPS, static_cast<uint16_t>((crosstalkValue << 9) / 1000));
+		}
+		return status;
+	}
+
+private:
+	Bus& bus;
+
+	/**
+	 * I2C address of the sensor
+	 */
+	uint8_t address;
+
+	uint8_t interruptPolarity = 0;
+
+	/**
+	 * The sensor's default configuration is the long distance mode
+	 */
+	DistanceMode distanceMode = DistanceMode::LONG;
+
+	/**
+	 * The last set timing budget (0 = not set)
+	 */
+	uint16_t timingBudgetMs = 0;
+
+	Status readRegisters(uint16_t registerAddress, uint8_t* data, uint8_t length) noexcept {
+		return this->bus.readRegister(this->address, registerAddress, data, length) == 0 ? Status::OK : Status::BUS_ERROR;
+	}
+
+	Status writeRegisters(uint16_t registerAddress, const uint8_t* data, uint8_t length) noexcept {
+		return this->bus.writeRegister(this->address, registerAddress, data, length) == 0 ? Status::OK : Status::BUS_ERROR;
+	}
+
+	Status read8(uint16_t registerAddress, uint8_t& value) noexcept {
+		return this->readRegisters(registerAddress, &value, 1);
+	}
+
+	Status read16(uint16_t registerAddress, uint16_t& value) noexcept {
+		uint8_t buffer[2] = {0, 0};
+		Status status = this->readRegisters(registerAddress, buffer, 2);
+		value = static_cast<uint16_t>((buffer[0] << 8) | buffer[1]);
+		return status;
+	}
+
+	Status write8(uint16_t registerAddress, uint8_t value) noexcept {
+		return this->writeRegisters(registerAddress, &value, 1);
+	}
+
+	Status write16(uint16_t registerAddress, uint16_t value) noexcept {
+		uint8_t buffer[2] = {static_cast<uint8_t>(value >> 8), static_cast<uint8_t>(value)};
+		return this->writeRegisters(registerAddress, buffer, 2);
+	}
+
+	Status write32(uint16_t registerAddress, uint32_t value) noexcept {
+		uint8_t buffer[4] = {
+			static_cast<uint8_t>(value >> 24),
+			static_cast<uint8_t>(value >> 16),
+			static_cast<uint8_t>(value >> 8),
+			static_cast<uint8_t>(value),
+		};
+		return this->writeRegisters(registerAddress, buffer, 4);
+	}
+};
@@ -1,7 +1,10 @@
 #include "VL53L1X.hpp"
 
+#include <cstdlib>
 #include <cstring>
 #include <fstream>
+#include <map>
+#include <system_error>
 #include <thread>
 #include <utility>
 
@@ -14,25 +17,88 @@ VL53L1X::VL53L1X(
 	std::chrono::milliseconds timeout
 ):
 	i2cBus(std::move(i2cBus)),
+	busMutex(VL53L1X::getBusMutex(this->i2cBus)),
 	gpioPin(std::move(gpioPin)),
 	address(address),
 	timeout(timeout),
 	interruptPolarity(0),
-	decimal(0.0) {}
+	decimal(0.0),
+	configurationEpoch(0) {}
+
+VL53L1X::Mutex::Mutex() {
+	pthread_mutexattr_t attributes;
+	int error = ::pthread_mutexattr_init(&attributes);
+	if (error == 0) {
+		error = ::pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE);
+	}
+	if (error == 0) {
+		error = ::pthread_mutexattr_setprotocol(&attributes, PTHREAD_PRIO_INHERIT);
+	}
+	if (error == 0) {
+		error = ::pthread_mutex_init(&this->mutex, &attributes);
+	}
+	::pthread_mutexattr_destroy(&attributes);
+	if (error != 0) {
+		throw std::system_error(error, std::generic_category(), "Creating the mutex failed");
+	}
+}
+
+VL53L1X::Mutex::~Mutex() {
+	::pthread_mutex_destroy(&this->mutex);
+}
+
+void VL53L1X::Mutex::lock() {
+	int error = ::pthread_mutex_lock(&this->mutex);
+	if (error != 0) {
+		throw std::system_error(error, std::generic_category(), "Locking the mutex failed");
+	}
+}
+
+bool VL53L1X::Mutex::try_lock() {
+	return ::pthread_mutex_trylock(&this->mutex) == 0;
+}
+
+void VL53L1X::Mutex::unlock() {
+	::pthread_mutex_unlock(&this->mutex);
+}
+
+std::shared_ptr<VL53L1X::Mutex> VL53L1X::getBusMutex(const I2CBus::SharedPtr& i2cBus) {
+	static std::mutex registryMutex;
+	static std::map<const I2CBus*, std::weak_ptr<VL53L1X::Mutex>> registry;
+
+	const std::lock_guard<std::mutex> lock(registryMutex);
+	auto busMutex = registry[i2cBus.get()].lock();
+	if (!busMutex) {
+		busMutex = std::make_shared<VL53L1X::Mutex>();
+		registry[i2cBus.get()] = busMutex;
+	}
+	return busMutex;
+}
 
 void VL53L1X::initialize() {
+	this->loadDefaultConfiguration();
+	while (!this->isDataReady()) {
+		std::this_thread::sleep_for(500ms);
+	}
+	this->finishInitialization();
+}
+
+void VL53L1X::loadDefaultConfiguration() {
+	auto lock = this->lockTransaction();
 	// TODO: soft-restart, GPIO restart (?)
 
 	// Write the default configuration, registers 0x2D to 0x87
 	for (uint8_t configAddr = 0x2D; configAddr <= 0x87; configAddr++) {
 		this->i2cBus->write8Reg16(this->address, configAddr, VL53L1X::DEFAULT_CONFIGURATION[configAddr - 0x2D]);
 	}
-	this->startRanging();
-	while (!this->isDataReady()) {
-		std::this_thread::sleep_for(500ms);
-	}
+	// Not using startRanging() so that the cached ranging state is left intact
+	this->i2cBus->write8Reg16(this->address, SYSTEM_MODE_START, 0x40);
+}
+
+void VL53L1X::finishInitialization() {
+	auto lock = this->lockTransaction();
 	this->clearInterrupt();
-	this->stopRanging();
+	this->i2cBus->write8Reg16(this->address, SYSTEM_MODE_START, 0x00);
 	// two bounds VHV
 	this->i2cBus->write8Reg16(this->address, VHV_CONFIG_TIMEOUT_MACROP_LOOP_BOUND, 0x09);
 	this->i2cBus->write8Reg16(this->address, VHV_CONFIG_INIT, 0);
@@ -41,6 +107,7 @@ void VL53L1X::initialize() {
 }
 
 void VL53L1X::powerOn() {
+	const std::lock_guard<VL53L1X::Mutex> lock(this->stateMutex);
 	if (!this->gpioPin) {
 		return;
 	}
@@ -51,6 +118,7 @@ void VL53L1X::powerOn() {
 }
 
 void VL53L1X::powerOff() {
+	const std::lock_guard<VL53L1X::Mutex> lock(this->stateMutex);
 	if (!this->gpioPin) {
 		return;
 	}
@@ -58,166 +126,268 @@ void VL53L1X::powerOff() {
 }
 
 void VL53L1X::setAddress(uint8_t newAddress) {
+	auto lock = this->lockTransaction();
 	this->i2cBus->write8Reg16(this->address, I2C_SLAVE_DEVICE_ADDRESS, newAddress & 0x7F);
 	this->address = newAddress;
 }
 
+uint8_t VL53L1X::getAddress() const {
+	const std::lock_guard<VL53L1X::Mutex> lock(this->stateMutex);
+	return this->address;
+}
+
+void VL53L1X::restoreAddress() {
+	auto lock = this->lockTransaction();
+	if (!this->gpioPin || this->address == VL53L1X::DEFAULT_DEVICE_ADDRESS) {
+		return;
+	}
+	this->i2cBus->write8Reg16(VL53L1X::DEFAULT_DEVICE_ADDRESS, I2C_SLAVE_DEVICE_ADDRESS, this->address & 0x7F);
+}
+
+void VL53L1X::restoreConfiguration() {
+	auto lock = this->lockTransaction();
+	// Copy, as the setters below update the cache
+	const CachedConfiguration configuration = this->cachedConfiguration;
+
+	if (configuration.distanceMode) {
+		this->setDistanceMode(*configuration.distanceMode);
+	}
+	if (configuration.timingBudgetMs) {
+		this->setTimingBudgetMs(*configuration.timingBudgetMs);
+	}
+	if (configuration.interMeasurementPeriod) {
+		this->setInterMeasurementPeriod(*configuration.interMeasurementPeriod);
+	}
+	if (configuration.offset) {
+		this->setOffset(*configuration.offset);
+	}
+	if (configuration.crosstalk) {
+		this->i2cBus->write16Reg16(this->address, ALGO_CROSSTALK_COMPENSATION_X_PLANE_GRADIENT_KCPS, 0x0000);
+		this->i2cBus->write16Reg16(this->address, ALGO_CROSSTALK_COMPENSATION_Y_PLANE_GRADIENT_KCPS, 0x0000);
+		this->i2cBus->write16Reg16(this->address, ALGO_CROSSTALK_COMPENSATION_PLANE_OFFSET_KCPS, *configuration.crosstalk);
+	}
+	if (configuration.ranging) {
+		this->startRanging();
+	}
+}
+
+uint16_t VL53L1X::getSensorId() {
+	auto lock = this->lockTransaction();
+	return this->i2cBus->read16Reg16(this->address, VL53L1_IDENTIFICATION_MODEL_ID);
+}
+
+uint32_t VL53L1X::getConfigurationEpoch() const {
+	const std::lock_guard<VL53L1X::Mutex> lock(this->stateMutex);
+	return this->configurationEpoch;
+}
+
 void VL53L1X::clearInterrupt() {
+	auto lock = this->lockTransaction();
 	this->i2cBus->write8Reg16(this->address, SYSTEM_INTERRUPT_CLEAR, 0x01);
 }
 
 void VL53L1X::startRanging() {
+	auto lock = this->lockTransaction();
 	this->i2cBus->write8Reg16(this->address, SYSTEM_MODE_START, 0x40);
+	this->cachedConfiguration.ranging = true;
 }
 
 void VL53L1X::stopRanging() {
+	auto lock = this->lockTransaction();
 	this->i2cBus->write8Reg16(this->address, SYSTEM_MODE_START, 0x00);
+	this->cachedConfiguration.ranging = false;
 }
 
 bool VL53L1X::isDataReady() {
+	auto lock = this->lockTransaction();
 	return (this->i2cBus->read8Reg16(this->address, GPIO_TIO_HV_STATUS) & 0x01) == this->interruptPolarity;
 }
 
 void VL53L1X::setTimingBudget(VL53L1X::TimingBudget timingBudget) {
+	auto lock = this->lockTransaction();
 	auto distanceMode = this->getDistanceMode();
-	if (distanceMode == VL53L1X::DISTANCE_MODE_SHORT) {
-		// Short DistanceMode
-		switch (timingBudget) {
-			case TIMING_BUDGET_15_MS:
-				// only available in short distance mode
-				this->i2cBus->write16Reg16(this->address, RANGE_CONFIG_TIMEOUT_MACROP_A_HI, 0x001D);
-				this->i2cBus->write16Reg16(this->address, RANGE_CONFIG_TIMEOUT_MACROP_B_HI, 0x0027);
-				break;
-			case TIMING_BUDGET_20_MS:
-				this->i2cBus->write16Reg16(this->address, RANGE_CONFIG_TIMEOUT_MACROP_A_HI, 0x0051);
-				this->i2cBus->write16Reg16(this->address, RANGE_CONFIG_TIMEOUT_MACROP_B_HI, 0x006E);
-				break;
-			case TIMING_BUDGET_33_MS:
-				this->i2cBus->write16Reg16(this->address, RANGE_CONFIG_TIMEOUT_MACROP_A_HI, 0x00D6);
-				this->i2cBus->write16Reg16(this->address, RANGE_CONFIG_TIMEOUT_MACROP_B_HI, 0x006E);
-				break;
-			case TIMING_BUDGET_50_MS:
-				this->i2cBus->write16Reg16(this->address, RANGE_CONFIG_TIMEOUT_MACROP_A_HI, 0x01AE);
-				this->i2cBus->write16Reg16(this->address, RANGE_CONFIG_TIMEOUT_MACROP_B_HI, 0x01E8);
-				break;
-			case TIMING_BUDGET_100_MS:
-				this->i2cBus->write16Reg16(this->address, RANGE_CONFIG_TIMEOUT_MACROP_A_HI, 0x02E1);
-				this->i2cBus->write16Reg16(this->address, RANGE_CONFIG_TIMEOUT_MACROP_B_HI, 0x0388);
-				break;
-			case TIMING_BUDGET_200_MS:
-				this->i2cBus->write16Reg16(this->address, RANGE_CONFIG_TIMEOUT_MACROP_A_HI, 0x03E1);
-				this->i2cBus->write16Reg16(this->address, RANGE_CONFIG_TIMEOUT_MACROP_B_HI, 0x0496);
-				break;
-			case TIMING_BUDGET_500_MS:
-				this->i2cBus->write16Reg16(this->address, RANGE_CONFIG_TIMEOUT_MACROP_A_HI, 0x0591);
-				this->i2cBus->write16Reg16(this->address, RANGE_CONFIG_TIMEOUT_MACROP_B_HI, 0x05C1);
-				break;
-			default:
-				break;
+	if (distanceMode != VL53L1X::DISTANCE_MODE_SHORT && timingBudget < VL53L1X::MIN_LONG_MODE_TIMING_BUDGET_MS) {
+		// 15 ms is only available in short distance mode
+		return;
+	}
+	if (distanceMode == VL53L1X::DISTANCE_MODE_MEDIUM) {
+		// No tuned table for the medium mode, calculate from the macro period
+		if (!this->writeTimingBudget(static_cast<uint32_t>(timingBudget) * 1000)) {
+			return;
 		}
-	} else if (distanceMode == VL53L1X::DISTANCE_MODE_LONG) {
-		switch (timingBudget) {
-			case TIMING_BUDGET_20_MS:
-				this->i2cBus->write16Reg16(this->address, RANGE_CONFIG_TIMEOUT_MACROP_A_HI, 0x001E);
-				this->i2cBus->write16Reg16(this->address, RANGE_CONFIG_TIMEOUT_MACROP_B_HI, 0x0022);
-				break;
-			case TIMING_BUDGET_33_MS:
-				this->i2cBus->write16Reg16(this->address, RANGE_CONFIG_TIMEOUT_MACROP_A_HI, 0x0060);
-				this->i2cBus->write16Reg16(this->address, RANGE_CONFIG_TIMEOUT_MACROP_B_HI, 0x006E);
-				break;
-			case TIMING_BUDGET_50_MS:
-				this->i2cBus->write16Reg16(this->address, RANGE_CONFIG_TIMEOUT_MACROP_A_HI, 0x00AD);
-				this->i2cBus->write16Reg16(this->address, RANGE_CONFIG_TIMEOUT_MACROP_B_HI, 0x00C6);
-				break;
-			case TIMING_BUDGET_100_MS:
-				this->i2cBus->write16Reg16(this->address, RANGE_CONFIG_TIMEOUT_MACROP_A_HI, 0x01CC);
-				this->i2cBus->write16Reg16(this->address, RANGE_CONFIG_TIMEOUT_MACROP_B_HI, 0x01EA);
-				break;
-			case TIMING_BUDGET_200_MS:
-				this->i2cBus->write16Reg16(this->address, RANGE_CONFIG_TIMEOUT_MACROP_A_HI, 0x02D9);
-				this->i2cBus->write16Reg16(this->address, RANGE_CONFIG_TIMEOUT_MACROP_B_HI, 0x02F8);
-				break;
-			case TIMING_BUDGET_500_MS:
-				this->i2cBus->write16Reg16(this->address, RANGE_CONFIG_TIMEOUT_MACROP_A_HI, 0x048F);
-				this->i2cBus->write16Reg16(this->address, RANGE_CONFIG_TIMEOUT_MACROP_B_HI, 0x04A4);
-				break;
-			default:
-				break;
+	} else {
+		const TimingBudgetSettings* settings = VL53L1X::findTimingBudgetSettings(distanceMode, timingBudget);
+		if (settings == nullptr) {
+			return;
 		}
+		this->i2cBus->write16Reg16(this->address, RANGE_CONFIG_TIMEOUT_MACROP_A_HI, settings->timeoutA);
+		this->i2cBus->write16Reg16(this->address, RANGE_CONFIG_TIMEOUT_MACROP_B_HI, settings->timeoutB);
 	}
+	// Cache only what was actually applied, restoreConfiguration() re-applies it after a reset
+	this->cachedConfiguration.timingBudgetMs = timingBudget;
+	this->configurationEpoch++;
 }
 
 VL53L1X::TimingBudget VL53L1X::getTimingBudget() {
+	// Table values are returned exactly, calculated ones (e.g. in the medium mode) are rounded to the nearest
+	uint16_t timingBudgetMs = this->getTimingBudgetMs();
+	if (timingBudgetMs == 0) {
+		return TIMING_BUDGET_20_MS;
+	}
+	static constexpr VL53L1X::TimingBudget timingBudgets[] = {
+		TIMING_BUDGET_15_MS,
+		TIMING_BUDGET_20_MS,
+		TIMING_BUDGET_33_MS,
+		TIMING_BUDGET_50_MS,
+		TIMING_BUDGET_100_MS,
+		TIMING_BUDGET_200_MS,
+		TIMING_BUDGET_500_MS
+	};
+	VL53L1X::TimingBudget nearest = timingBudgets[0];
+	for (VL53L1X::TimingBudget timingBudget : timingBudgets) {
+		if (std::abs(timingBudget - timingBudgetMs) < std::abs(nearest - timingBudgetMs)) {
+			nearest = timingBudget;
+		}
+	}
+	return nearest;
+}
+
+void VL53L1X::setTimingBudgetMs(uint16_t timingBudgetMs) {
+	auto lock = this->lockTransaction();
+	auto distanceMode = this->getDistanceMode();
+	if (distanceMode != VL53L1X::DISTANCE_MODE_SHORT && timingBudgetMs < VL53L1X::MIN_LONG_MODE_TIMING_BUDGET_MS) {
+		return;
+	}
+	if (VL53L1X::findTimingBudgetSettings(distanceMode, timingBudgetMs) != nullptr) {
+		this->setTimingBudget(static_cast<VL53L1X::TimingBudget>(timingBudgetMs));
+		return;
+	}
+	if (this->writeTimingBudget(static_cast<uint32_t>(timingBudgetMs) * 1000)) {
+		this->cachedConfiguration.timingBudgetMs = timingBudgetMs;
+		this->configurationEpoch++;
+	}
+}
+
+uint16_t VL53L1X::getTimingBudgetMs() {
+	auto lock = this->lockTransaction();
 	uint16_t configValue = this->i2cBus->read16Reg16(this->address, RANGE_CONFIG_TIMEOUT_MACROP_A_HI);
-	switch (configValue) {
-		case 0x0051:
-		case 0x001E:
-			return TIMING_BUDGET_20_MS;
+	uint16_t timingBudget = VL53L1X::lookUpTimingBudget(this->getDistanceMode(), configValue);
+	if (timingBudget != 0) {
+		return timingBudget;
+	}
 
-		case 0x00D6:
-		case 0x0060:
-			return TIMING_BUDGET_33_MS;
+	uint32_t macroPeriod = this->getMacroPeriod(this->i2cBus->read8Reg16(this->address, RANGE_CONFIG_VCSEL_PERIOD_A));
+	if (macroPeriod == 0) {
+		return 0;
+	}
+	uint32_t timeoutUs = VL53L1X::decodeTimeout(configValue, macroPeriod);
+	return static_cast<uint16_t>((2 * timeoutUs + VL53L1X::TIMING_GUARD_US + 500) / 1000);
+}
 
-		case 0x1AE:
-		case 0x00AD:
-			return TIMING_BUDGET_50_MS;
+const VL53L1X::TimingBudgetSettings* VL53L1X::findTimingBudgetSettings(
+	VL53L1X::DistanceMode mode,
+	uint16_t timingBudgetMs
+) {
+	if (mode == VL53L1X::DISTANCE_MODE_SHORT) {
+		return VL53L1X::findTimingBudget(VL53L1X::SHORT_MODE_TIMING_BUDGETS, timingBudgetMs);
+	}
+	if (mode == VL53L1X::DISTANCE_MODE_LONG) {
+		return VL53L1X::findTimingBudget(VL53L1X::LONG_MODE_TIMING_BUDGETS, timingBudgetMs);
+	}
+	return nullptr;
+}
 
-		case 0x02E1:
-		case 0x01CC:
-			return TIMING_BUDGET_100_MS;
+uint16_t VL53L1X::lookUpTimingBudget(VL53L1X::DistanceMode mode, uint16_t configValue) {
+	const TimingBudgetSettings* settings = nullptr;
+	if (mode == VL53L1X::DISTANCE_MODE_SHORT) {
+		settings = VL53L1X::findTimingBudgetByTimeout(VL53L1X::SHORT_MODE_TIMING_BUDGETS, configValue);
+	} else if (mode == VL53L1X::DISTANCE_MODE_LONG) {
+		settings = VL53L1X::findTimingBudgetByTimeout(VL53L1X::LONG_MODE_TIMING_BUDGETS, configValue);
+	}
+	return settings ? settings->timingBudgetMs : 0;
+}
 
-		case 0x03E1:
-		case 0x02D9:
-			return TIMING_BUDGET_200_MS;
+uint32_t VL53L1X::getMacroPeriod(uint8_t vcselPeriod) {
+	uint16_t fastOscFrequency = this->i2cBus->read16Reg16(this->address, OSC_MEASURED_FAST_OSC_FREQUENCY);
+	return VL53L1X::calculateMacroPeriod(fastOscFrequency, vcselPeriod);
+}
 
-		case 0x0591:
-		case 0x048F:
-			return TIMING_BUDGET_500_MS;
+bool VL53L1X::writeTimingBudget(uint32_t timingBudgetUs) {
+	if (timingBudgetUs <= VL53L1X::TIMING_GUARD_US) {
+		return false;
+	}
+	// Both VCSEL periods (A and B) get half of the budget left after the guard
+	uint32_t rangeTimeoutUs = timingBudgetUs - VL53L1X::TIMING_GUARD_US;
+	if (rangeTimeoutUs > 1100000) {
+		return false;
+	}
+	rangeTimeoutUs /= 2;
 
-		default:
-			return TIMING_BUDGET_20_MS;
+	uint32_t macroPeriodA = this->getMacroPeriod(this->i2cBus->read8Reg16(this->address, RANGE_CONFIG_VCSEL_PERIOD_A));
+	uint32_t macroPeriodB = this->getMacroPeriod(this->i2cBus->read8Reg16(this->address, RANGE_CONFIG_VCSEL_PERIOD_B));
+	if (macroPeriodA == 0 || macroPeriodB == 0) {
+		return false;
 	}
+	this->i2cBus->write16Reg16(this->address, RANGE_CONFIG_TIMEOUT_MACROP_A_HI, VL53L1X::encodeTimeout(rangeTimeoutUs, macroPeriodA));
+	this->i2cBus->write16Reg16(this->address, RANGE_CONFIG_TIMEOUT_MACROP_B_HI, VL53L1X::encodeTimeout(rangeTimeoutUs, macroPeriodB));
+	return true;
 }
 
 void VL53L1X::setDistanceMode(VL53L1X::DistanceMode mode) {
-	VL53L1X::TimingBudget budget = this->getTimingBudget();
+	auto lock = this->lockTransaction();
+	uint16_t budget = this->getTimingBudgetMs();
+	this->cachedConfiguration.distanceMode = mode;
+	this->configurationEpoch++;
 
+	const DistanceModeSettings* settings = nullptr;
 	switch (mode) {
 		case VL53L1X::DISTANCE_MODE_SHORT:
-			this->i2cBus->write8Reg16(this->address, PHASECAL_CONFIG_TIMEOUT_MACROP, 0x14);
-			this->i2cBus->write8Reg16(this->address, RANGE_CONFIG_VCSEL_PERIOD_A, 0x07);
-			this->i2cBus->write8Reg16(this->address, RANGE_CONFIG_VCSEL_PERIOD_B, 0x05);
-			this->i2cBus->write8Reg16(this->address, RANGE_CONFIG_VALID_PHASE_HIGH, 0x38);
-			this->i2cBus->write16Reg16(this->address, SD_CONFIG_WOI_SD0, 0x0705);
-			this->i2cBus->write16Reg16(this->address, SD_CONFIG_INITIAL_PHASE_SD0, 0x0606);
+			settings = &VL53L1X::SHORT_MODE_SETTINGS;
+			break;
+		case VL53L1X::DISTANCE_MODE_MEDIUM:
+			settings = &VL53L1X::MEDIUM_MODE_SETTINGS;
 			break;
 		case VL53L1X::DISTANCE_MODE_LONG:
-			this->i2cBus->write8Reg16(this->address, PHASECAL_CONFIG_TIMEOUT_MACROP, 0x0A);
-			this->i2cBus->write8Reg16(this->address, RANGE_CONFIG_VCSEL_PERIOD_A, 0x0F);
-			this->i2cBus->write8Reg16(this->address, RANGE_CONFIG_VCSEL_PERIOD_B, 0x0D);
-			this->i2cBus->write8Reg16(this->address, RANGE_CONFIG_VALID_PHASE_HIGH, 0xB8);
-			this->i2cBus->write16Reg16(this->address, SD_CONFIG_WOI_SD0, 0x0F0D);
-			this->i2cBus->write16Reg16(this->address, SD_CONFIG_INITIAL_PHASE_SD0, 0x0E0E);
+			settings = &VL53L1X::LONG_MODE_SETTINGS;
 			break;
 		default:
 			break;
 	}
-	this->setTimingBudget(budget);
+	if (settings != nullptr) {
+		this->i2cBus->write8Reg16(this->address, PHASECAL_CONFIG_TIMEOUT_MACROP, settings->phasecalTimeout);
+		this->i2cBus->write8Reg16(this->address, RANGE_CONFIG_VCSEL_PERIOD_A, settings->vcselPeriodA);
+		this->i2cBus->write8Reg16(this->address, RANGE_CONFIG_VCSEL_PERIOD_B, settings->vcselPeriodB);
+		this->i2cBus->write8Reg16(this->address, RANGE_CONFIG_VALID_PHASE_HIGH, settings->validPhaseHigh);
+		this->i2cBus->write16Reg16(this->address, SD_CONFIG_WOI_SD0, settings->windowOfInterest);
+		this->i2cBus->write16Reg16(this->address, SD_CONFIG_INITIAL_PHASE_SD0, settings->initialPhase);
+	}
+	// Budgets below 20 ms only exist in the short mode
+	if (mode != VL53L1X::DISTANCE_MODE_SHORT && budget != 0 && budget < VL53L1X::MIN_LONG_MODE_TIMING_BUDGET_MS) {
+		budget = VL53L1X::MIN_LONG_MODE_TIMING_BUDGET_MS;
+	}
+	this->setTimingBudgetMs(budget);
 }
 
 VL53L1X::DistanceMode VL53L1X::getDistanceMode() {
+	auto lock = this->lockTransaction();
 	uint8_t configValue = this->i2cBus->read8Reg16(this->address, PHASECAL_CONFIG_TIMEOUT_MACROP);
 
-	if (configValue == 0x14) {
+	if (configValue == VL53L1X::SHORT_MODE_SETTINGS.phasecalTimeout) {
 		return VL53L1X::DISTANCE_MODE_SHORT;
 	}
-	if (configValue == 0x0A) {
+	if (configValue == VL53L1X::LONG_MODE_SETTINGS.phasecalTimeout) {
 		return VL53L1X::DISTANCE_MODE_LONG;
 	}
+	if (configValue == VL53L1X::MEDIUM_MODE_SETTINGS.phasecalTimeout) {
+		return VL53L1X::DISTANCE_MODE_MEDIUM;
+	}
 	return VL53L1X::DISTANCE_MODE_UNKNOWN;
 }
 
 void VL53L1X::setInterMeasurementPeriod(uint16_t period) {
+	auto lock = this->lockTransaction();
+	this->cachedConfiguration.interMeasurementPeriod = period;
+	this->configurationEpoch++;
 	uint16_t clockPLL = 0x03FF & this->i2cBus->read16Reg16(this->address, VL53L1_RESULT_OSC_CALIBRATE_VAL);
 	auto periodRaw = static_cast<uint32_t>(clockPLL * period * 1.075);
 	this->i2cBus->write32Reg16(this->address, VL53L1_SYSTEM_INTERMEASUREMENT_PERIOD, periodRaw);
@@ -230,43 +400,76 @@ void VL53L1X::setInterMeasurementPeriod(uint16_t period) {
 }
 
 uint16_t VL53L1X::getInterMeasurementPeriod() {
+	auto lock = this->lockTransaction();
 	uint16_t clockPLL = 0x03FF & this->i2cBus->read16Reg16(this->address, VL53L1_RESULT_OSC_CALIBRATE_VAL);
 	uint32_t period = this->i2cBus->read32Reg16(this->address, VL53L1_SYSTEM_INTERMEASUREMENT_PERIOD);
 
 	return static_cast<uint16_t>((period + this->decimal) / (clockPLL * 1.075));
 }
 
+std::chrono::nanoseconds VL53L1X::getMeasurementPeriod() {
+	auto lock = this->lockTransaction();
+	uint16_t clockPLL = 0x03FF & this->i2cBus->read16Reg16(this->address, VL53L1_RESULT_OSC_CALIBRATE_VAL);
+	uint32_t period = this->i2cBus->read32Reg16(this->address, VL53L1_SYSTEM_INTERMEASUREMENT_PERIOD);
+	if (clockPLL == 0) {
+		return std::chrono::nanoseconds(0);
+	}
+
+	// The period register counts (clockPLL * 1.075) ticks per millisecond, see setInterMeasurementPeriod()
+	return std::chrono::nanoseconds(static_cast<int64_t>(period * 1000000.0 / (clockPLL * 1.075)));
+}
+
 uint16_t VL53L1X::getDistance() {
-	auto startTime = std::chrono::system_clock::now();
-	while (true) {
-		if (this->isDataReady()) {
-			break;
-		}
-		if (this->timeout.count() && std::chrono::system_clock::now() - startTime > this->timeout) {
-			return 65535;
+	return this->getSample().distance;
+}
+
+VL53L1X::Sample VL53L1X::getSample() {
+	auto startTime = std::chrono::steady_clock::now();
+	VL53L1X::Sample sample = {65535, startTime};
+	while (!this->tryGetSample(sample)) {
+		if (this->timeout.count() && std::chrono::steady_clock::now() - startTime > this->timeout) {
+			return {65535, std::chrono::steady_clock::now()};
 		}
 		std::this_thread::sleep_for(5ms);
 	}
+	return sample;
+}
+
+bool VL53L1X::tryGetSample(VL53L1X::Sample& sample) {
+	// Hold the locks from the data-ready check until the interrupt is cleared, so that no other thread can read
+	// (or clear) the same sample in between
+	auto lock = this->lockTransaction();
+	if (!this->isDataReady()) {
+		return false;
+	}
+	auto timestamp = std::chrono::steady_clock::now();
+
 	uint16_t distance = this->i2cBus->read16Reg16(this->address, VL53L1_RESULT_FINAL_CROSSTALK_CORRECTED_RANGE_MM_SD0);
 	this->clearInterrupt();
 	if (distance > 4000) {
 		distance = 16384;
 	}
-	return distance;
+	sample = {distance, timestamp};
+	return true;
 }
 
 uint16_t VL53L1X::getSignalRate() {
+	auto lock = this->lockTransaction();
 	return 8 * this->i2cBus->read16Reg16(this->address, VL53L1_RESULT_DSS_ACTUAL_EFFECTIVE_SPADS_SD0);
 }
 
 void VL53L1X::setOffset(int16_t offsetValue) {
+	auto lock = this->lockTransaction();
 	auto offsetRaw = static_cast<uint16_t>(offsetValue * 4);
 	this->i2cBus->write16Reg16(this->address, ALGO_PART_TO_PART_RANGE_OFFSET_MM, offsetRaw);
 	this->i2cBus->write16Reg16(this->address, MM_CONFIG_INNER_OFFSET_MM, 0x0);
 	this->i2cBus->write16Reg16(this->address, MM_CONFIG_OUTER_OFFSET_MM, 0x0);
+	this->cachedConfiguration.offset = offsetValue;
+	this->configurationEpoch++;
 }
 
 int16_t VL53L1X::getOffset() {
+	auto lock = this->lockTransaction();
 	uint16_t tmp = this->i2cBus->read16Reg16(this->address, ALGO_PART_TO_PART_RANGE_OFFSET_MM);
 	// adjust
 	if (tmp & 0x1000) {
@@ -277,31 +480,41 @@ int16_t VL53L1X::getOffset() {
 }
 
 void VL53L1X::setCrosstalk(uint16_t crosstalkValue) {
+	auto lock = this->lockTransaction();
 	uint16_t crosstalkRaw = (crosstalkValue << 9) / 1000;
 	this->i2cBus->write16Reg16(this->address, ALGO_CROSSTALK_COMPENSATION_X_PLANE_GRADIENT_KCPS, 0x0000);
 	this->i2cBus->write16Reg16(this->address, ALGO_CROSSTALK_COMPENSATION_Y_PLANE_GRADIENT_KCPS, 0x0000);
 	this->i2cBus->write16Reg16(this->address, ALGO_CROSSTALK_COMPENSATION_PLANE_OFFSET_KCPS, crosstalkRaw);
+	this->cachedConfiguration.crosstalk = crosstalkRaw;
+	this->configurationEpoch++;
 }
 
 uint16_t VL53L1X::getCrosstalk() {
+	auto lock = this->lockTransaction();
 	uint16_t crosstalk = this->i2cBus->read16Reg16(this->address, ALGO_CROSSTALK_COMPENSATION_PLANE_OFFSET_KCPS);
 	return (crosstalk * 1000) >> 9;
 }
 
 uint16_t VL53L1X::getDistanceThresholdLow() {
+	auto lock = this->lockTransaction();
 	return this->i2cBus->read16Reg16(this->address, SYSTEM_THRESH_LOW);
 }
 
 uint16_t VL53L1X::getDistanceThresholdHigh() {
+	auto lock = this->lockTransaction();
 	return this->i2cBus->read16Reg16(this->address, SYSTEM_THRESH_HIGH);
 }
 
 int8_t VL53L1X::calibrateOffset(uint16_t targetDistance) {
+	const std::lock_guard<VL53L1X::Mutex> lock(this->stateMutex);
 	constexpr uint8_t numberOfMeasurements = 50;
 
-	this->i2cBus->write16Reg16(this->address, ALGO_PART_TO_PART_RANGE_OFFSET_MM, 0x0);
-	this->i2cBus->write16Reg16(this->address, MM_CONFIG_INNER_OFFSET_MM, 0x0);
-	this->i2cBus->write16Reg16(this->address, MM_CONFIG_OUTER_OFFSET_MM, 0x0);
+	{
+		auto transactionLock = this->lockTransaction();
+		this->i2cBus->write16Reg16(this->address, ALGO_PART_TO_PART_RANGE_OFFSET_MM, 0x0);
+		this->i2cBus->write16Reg16(this->address, MM_CONFIG_INNER_OFFSET_MM, 0x0);
+		this->i2cBus->write16Reg16(this->address, MM_CONFIG_OUTER_OFFSET_MM, 0x0);
+	}
 
 	this->startRanging();
 	int16_t averageDistance = 0;
@@ -316,14 +529,23 @@ int8_t VL53L1X::calibrateOffset(uint16_t targetDistance) {
 
 	averageDistance = averageDistance / numberOfMeasurements;
 	int16_t offset = targetDistance - averageDistance;
-	this->i2cBus->write16Reg16(this->address, ALGO_PART_TO_PART_RANGE_OFFSET_MM, offset * 4);
+	{
+		auto transactionLock = this->lockTransaction();
+		this->i2cBus->write16Reg16(this->address, ALGO_PART_TO_PART_RANGE_OFFSET_MM, offset * 4);
+	}
+	this->cachedConfiguration.offset = offset;
+	this->configurationEpoch++;
 	return offset;
 }
 
 int8_t VL53L1X::calibrateCrosstalk(uint16_t targetDistance) {
+	const std::lock_guard<VL53L1X::Mutex> lock(this->stateMutex);
 	constexpr uint8_t numberOfMeasurements = 50;
 
-	this->i2cBus->write16Reg16(this->address, ALGO_CROSSTALK_COMPENSATION_PLANE_OFFSET_KCPS, 0);
+	{
+		auto transactionLock = this->lockTransaction();
+		this->i2cBus->write16Reg16(this->address, ALGO_CROSSTALK_COMPENSATION_PLANE_OFFSET_KCPS, 0);
+	}
 
 	this->startRanging();
 	float averageSignalRate = 0;
@@ -347,6 +569,15 @@ int8_t VL53L1X::calibrateCrosstalk(uint16_t targetDistance) {
 	// Calculate Xtalk value
 	float crosstalk = (averageSignalRate * (1 - averageDistance / static_cast<float>(targetDistance))) / averageSpadNb;
 	uint16_t crosstalkU16 = 512 * static_cast<uint16_t>(crosstalk);
-	this->i2cBus->write16Reg16(this->address, ALGO_CROSSTALK_COMPENSATION_PLANE_OFFSET_KCPS, crosstalkU16);
+	{
+		auto transactionLock = this->lockTransaction();
+		this->i2cBus->write16Reg16(this->address, ALGO_CROSSTALK_COMPENSATION_PLANE_OFFSET_KCPS, crosstalkU16);
+	}
+	this->cachedConfiguration.crosstalk = crosstalkU16;
+	this->configurationEpoch++;
 	return crosstalkU16;
 }
+
+std::scoped_lock<VL53L1X::Mutex, VL53L1X::Mutex> VL53L1X::lockTransaction() {
+	return std::scoped_lock<VL53L1X::Mutex, VL53L1X::Mutex>(this->stateMutex, *this->busMutex);
+}
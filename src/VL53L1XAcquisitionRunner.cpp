@@ -0,0 +1,227 @@
+#include "VL53L1XAcquisitionRunner.hpp"
+
+#include "VL53L1XClockEstimator.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <time.h>
+
+VL53L1XAcquisitionRunner::VL53L1XAcquisitionRunner(
+	VL53L1X::SharedPtr sensor,
+	Callback callback,
+	int priority,
+	int cpu,
+	bool lockMemory
+):
+	sensor(std::move(sensor)),
+	callback(std::move(callback)),
+	priority(priority),
+	cpu(cpu),
+	lockMemory(lockMemory),
+	running(false),
+	errorCount(0) {}
+
+VL53L1XAcquisitionRunner::~VL53L1XAcquisitionRunner() {
+	this->stop();
+}
+
+void VL53L1XAcquisitionRunner::start() {
+	if (this->thread.joinable()) {
+		return;
+	}
+	std::chrono::nanoseconds period = this->sensor->getMeasurementPeriod();
+	if (period.count() <= 0) {
+		throw std::runtime_error("Unable to determine the sensor's measurement period");
+	}
+	std::chrono::nanoseconds timingBudget = std::chrono::milliseconds(this->sensor->getTimingBudgetMs());
+	// The thread is not running, so the pending resets can be applied here
+	VL53L1XAcquisitionRunner::applyReset(this->wakeUpJitter);
+	VL53L1XAcquisitionRunner::applyReset(this->sampleAge);
+
+	std::promise<void> started;
+	auto startResult = started.get_future();
+	this->running = true;
+	this->thread = std::thread(&VL53L1XAcquisitionRunner::run, this, std::move(started), period, timingBudget);
+	try {
+		startResult.get();
+	} catch (...) {
+		this->stop();
+		throw;
+	}
+}
+
+void VL53L1XAcquisitionRunner::stop() {
+	this->running = false;
+	if (this->thread.joinable()) {
+		this->thread.join();
+	}
+}
+
+bool VL53L1XAcquisitionRunner::isRunning() const {
+	return this->running;
+}
+
+VL53L1XAcquisitionRunner::LatencyStatistics VL53L1XAcquisitionRunner::getWakeUpJitter() const {
+	return VL53L1XAcquisitionRunner::getStatistics(this->wakeUpJitter);
+}
+
+VL53L1XAcquisitionRunner::LatencyStatistics VL53L1XAcquisitionRunner::getSampleAge() const {
+	return VL53L1XAcquisitionRunner::getStatistics(this->sampleAge);
+}
+
+uint64_t VL53L1XAcquisitionRunner::getErrorCount() const {
+	return this->errorCount;
+}
+
+void VL53L1XAcquisitionRunner::resetStatistics() {
+	// Only the acquisition thread modifies the histories, it resets them before recording the next value
+	this->wakeUpJitter.resetRequested = true;
+	this->sampleAge.resetRequested = true;
+	this->errorCount = 0;
+}
+
+void VL53L1XAcquisitionRunner::run(
+	std::promise<void> started,
+	std::chrono::nanoseconds period,
+	std::chrono::nanoseconds timingBudget
+) {
+	try {
+		this->configureThread();
+	} catch (...) {
+		started.set_exception(std::current_exception());
+		return;
+	}
+	started.set_value();
+
+	// The estimator tracks the middle of the measurements, data-ready comes half the timing budget later
+	VL53L1XClockEstimator estimator(period, timingBudget);
+	const std::chrono::nanoseconds halfTimingBudget = timingBudget / 2;
+
+	Clock::time_point deadline = Clock::now();
+	while (this->running) {
+		VL53L1XAcquisitionRunner::sleepUntil(deadline);
+		Clock::time_point wakeUpTime = Clock::now();
+		VL53L1XAcquisitionRunner::record(this->wakeUpJitter, wakeUpTime - deadline);
+
+		try {
+			VL53L1X::Sample sample = {};
+			if (!this->sensor->tryGetSample(sample)) {
+				deadline = std::max(deadline + VL53L1XAcquisitionRunner::POLL_INTERVAL, wakeUpTime);
+				continue;
+			}
+			Clock::time_point readyTime = estimator.update(sample.timestamp) + halfTimingBudget;
+			VL53L1XAcquisitionRunner::record(this->sampleAge, Clock::now() - readyTime);
+			this->callback(sample);
+		} catch (const std::exception&) {
+			this->errorCount++;
+			deadline = wakeUpTime + period;
+			continue;
+		}
+
+		// Wake up a bit early and poll, so that the estimator keeps seeing detections close to the data-ready
+		deadline = std::max(
+			estimator.predictNext() + halfTimingBudget - VL53L1XAcquisitionRunner::WAKE_ADVANCE,
+			Clock::now()
+		);
+	}
+}
+
+void VL53L1XAcquisitionRunner::configureThread() const {
+	if (this->lockMemory) {
+		if (::mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+			throw std::system_error(errno, std::generic_category(), "Locking memory failed");
+		}
+		// Touch the stack, so that its pages are mapped (and locked) before the loop runs
+		volatile uint8_t stack[VL53L1XAcquisitionRunner::STACK_PREFAULT_SIZE];
+		for (std::size_t i = 0; i < sizeof(stack); i += 4096) {
+			stack[i] = 0;
+		}
+	}
+	if (this->cpu >= 0) {
+		cpu_set_t cpuSet;
+		CPU_ZERO(&cpuSet);
+		CPU_SET(this->cpu, &cpuSet);
+		int error = ::pthread_setaffinity_np(::pthread_self(), sizeof(cpuSet), &cpuSet);
+		if (error != 0) {
+			throw std::system_error(error, std::generic_category(), "Setting the CPU affinity failed");
+		}
+	}
+	if (this->priority > 0) {
+		sched_param parameters = {};
+		parameters.sched_priority = this->priority;
+		int error = ::pthread_setschedparam(::pthread_self(), SCHED_FIFO, &parameters);
+		if (error != 0) {
+			throw std::system_error(error, std::generic_category(), "Setting SCHED_FIFO priority failed");
+		}
+	}
+}
+
+void VL53L1XAcquisitionRunner::record(LatencyHistory& history, Clock::duration value) {
+	VL53L1XAcquisitionRunner::applyReset(history);
+	int64_t valueNs = std::chrono::duration_cast<std::chrono::nanoseconds>(value).count();
+
+	// Single writer: plain loads and stores, publishing the value by the release store of the count
+	uint64_t count = history.count.load(std::memory_order_relaxed);
+	history.values[count % VL53L1XAcquisitionRunner::HISTORY_SIZE].store(valueNs, std::memory_order_relaxed);
+	if (count == 0 || valueNs > history.max.load(std::memory_order_relaxed)) {
+		history.max.store(valueNs, std::memory_order_relaxed);
+	}
+	history.count.store(count + 1, std::memory_order_release);
+}
+
+void VL53L1XAcquisitionRunner::applyReset(LatencyHistory& history) {
+	if (history.resetRequested.load(std::memory_order_acquire)) {
+		history.count.store(0, std::memory_order_relaxed);
+		history.max.store(0, std::memory_order_relaxed);
+		history.resetRequested.store(false, std::memory_order_release);
+	}
+}
+
+VL53L1XAcquisitionRunner::LatencyStatistics VL53L1XAcquisitionRunner::getStatistics(const LatencyHistory& history) {
+	LatencyStatistics statistics;
+	if (history.resetRequested.load(std::memory_order_acquire)) {
+		return statistics;
+	}
+	uint64_t count = history.count.load(std::memory_order_acquire);
+	std::size_t size = std::min<uint64_t>(count, VL53L1XAcquisitionRunner::HISTORY_SIZE);
+	if (size == 0) {
+		return statistics;
+	}
+	std::vector<int64_t> values(size);
+	for (std::size_t i = 0; i < size; i++) {
+		values[i] = history.values[i].load(std::memory_order_relaxed);
+	}
+	std::sort(values.begin(), values.end());
+	statistics.count = count;
+	// The copied values may be newer than the maximum loaded before them
+	statistics.max = std::chrono::nanoseconds(std::max(history.max.load(std::memory_order_relaxed), values.back()));
+
+	// Nearest-rank percentiles
+	auto percentile = [&values](double fraction) {
+		auto rank = static_cast<std::size_t>(std::ceil(fraction * values.size()));
+		return std::chrono::nanoseconds(values[std::max<std::size_t>(rank, 1) - 1]);
+	};
+	statistics.p50 = percentile(0.5);
+	statistics.p90 = percentile(0.9);
+	statistics.p99 = percentile(0.99);
+	statistics.p999 = percentile(0.999);
+	return statistics;
+}
+
+void VL53L1XAcquisitionRunner::sleepUntil(Clock::time_point deadline) {
+	// steady_clock is CLOCK_MONOTONIC on Linux
+	int64_t deadlineNs = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+	timespec deadlineTime = {};
+	deadlineTime.tv_sec = static_cast<time_t>(deadlineNs / 1000000000);
+	deadlineTime.tv_nsec = static_cast<long>(deadlineNs % 1000000000);
+	while (::clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadlineTime, nullptr) == EINTR) {
+	}
+}
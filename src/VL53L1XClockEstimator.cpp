@@ -0,0 +1,96 @@
+#include "VL53L1XClockEstimator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+VL53L1XClockEstimator::VL53L1XClockEstimator(std::chrono::nanoseconds nominalPeriod, std::chrono::nanoseconds timingBudget):
+	nominalPeriodNs(static_cast<double>(nominalPeriod.count())),
+	halfTimingBudgetNs(timingBudget.count() / 2),
+	window(),
+	count(0),
+	head(0),
+	lastIndex(0),
+	lastTime(0),
+	periodNs(static_cast<double>(nominalPeriod.count())),
+	offsetNs(0.0) {}
+
+VL53L1XClockEstimator::Clock::time_point VL53L1XClockEstimator::update(Clock::time_point detectionTime) {
+	if (this->count == 0) {
+		this->origin = detectionTime;
+	}
+	int64_t time = std::chrono::duration_cast<std::chrono::nanoseconds>(detectionTime - this->origin).count();
+
+	int64_t index = 0;
+	if (this->count != 0) {
+		// Count the samples missed since the previous one (at least one step, as a new sample was detected)
+		int64_t steps = 1;
+		if (this->periodNs > 0.0) {
+			steps = std::max<int64_t>(1, std::llround(static_cast<double>(time - this->lastTime) / this->periodNs));
+		}
+		index = this->lastIndex + steps;
+	}
+	this->lastIndex = index;
+	this->lastTime = time;
+
+	this->window.at(this->head) = {index, time};
+	this->head = (this->head + 1) % VL53L1XClockEstimator::WINDOW_SIZE;
+	this->count = std::min(this->count + 1, VL53L1XClockEstimator::WINDOW_SIZE);
+	this->fit();
+
+	auto readyTime = static_cast<int64_t>(this->offsetNs + this->periodNs * static_cast<double>(index));
+	return this->origin + std::chrono::nanoseconds(readyTime - this->halfTimingBudgetNs);
+}
+
+VL53L1XClockEstimator::Clock::time_point VL53L1XClockEstimator::predictNext() const {
+	if (this->count == 0) {
+		return Clock::time_point();
+	}
+	auto readyTime = static_cast<int64_t>(this->offsetNs + this->periodNs * static_cast<double>(this->lastIndex + 1));
+	return this->origin + std::chrono::nanoseconds(readyTime - this->halfTimingBudgetNs);
+}
+
+std::chrono::nanoseconds VL53L1XClockEstimator::getPeriod() const {
+	return std::chrono::nanoseconds(static_cast<int64_t>(this->periodNs));
+}
+
+void VL53L1XClockEstimator::reset() {
+	this->count = 0;
+	this->head = 0;
+	this->lastIndex = 0;
+	this->lastTime = 0;
+	this->periodNs = this->nominalPeriodNs;
+	this->offsetNs = 0.0;
+}
+
+void VL53L1XClockEstimator::fit() {
+	// Least squares fit of the period, relative to the oldest point to keep the numbers small
+	if (this->count >= VL53L1XClockEstimator::MIN_FIT_SAMPLES) {
+		const Point& oldest = this->window.at(this->count < VL53L1XClockEstimator::WINDOW_SIZE ? 0 : this->head);
+		double sumX = 0.0;
+		double sumY = 0.0;
+		double sumXX = 0.0;
+		double sumXY = 0.0;
+		for (std::size_t i = 0; i < this->count; i++) {
+			auto x = static_cast<double>(this->window.at(i).index - oldest.index);
+			auto y = static_cast<double>(this->window.at(i).time - oldest.time);
+			sumX += x;
+			sumY += y;
+			sumXX += x * x;
+			sumXY += x * y;
+		}
+		auto n = static_cast<double>(this->count);
+		double denominator = n * sumXX - sumX * sumX;
+		if (denominator > 0.0) {
+			this->periodNs = (n * sumXY - sumX * sumY) / denominator;
+		}
+	}
+
+	// Lower envelope: a sample can't be detected before it's ready
+	double offset = std::numeric_limits<double>::max();
+	for (std::size_t i = 0; i < this->count; i++) {
+		const Point& point = this->window.at(i);
+		offset = std::min(offset, static_cast<double>(point.time) - this->periodNs * static_cast<double>(point.index));
+	}
+	this->offsetNs = offset;
+}
@@ -0,0 +1,189 @@
+#include "VL53L1XDiscovery.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <future>
+#include <thread>
+#include <utility>
+
+using namespace std::chrono_literals;
+
+VL53L1XDiscovery::VL53L1XDiscovery(
+	I2CBus::SharedPtr i2cBus,
+	const std::vector<uint8_t>& addressPool,
+	std::chrono::milliseconds timeout
+):
+	i2cBus(std::move(i2cBus)),
+	timeout(timeout),
+	freeAddresses(addressPool.begin(), addressPool.end()) {
+	// The default address is needed for bringing up the new sensors
+	this->freeAddresses.erase(VL53L1X::DEFAULT_DEVICE_ADDRESS);
+}
+
+std::vector<uint8_t> VL53L1XDiscovery::probe(uint8_t firstAddress, uint8_t lastAddress) {
+	std::vector<uint8_t> addresses;
+	for (unsigned address = firstAddress; address <= lastAddress; address++) {
+		if (this->isSensorAt(static_cast<uint8_t>(address))) {
+			addresses.push_back(static_cast<uint8_t>(address));
+		}
+	}
+	return addresses;
+}
+
+VL53L1X::SharedPtr VL53L1XDiscovery::addSensor(GPIOPin::SharedPtr gpioPin) {
+	auto sensor = this->bringUp(std::move(gpioPin));
+	if (sensor) {
+		sensor->initialize();
+	}
+	return sensor;
+}
+
+void VL53L1XDiscovery::removeSensor(const VL53L1X::SharedPtr& sensor) {
+	sensor->powerOff();
+	for (auto it = this->assignedAddresses.begin(); it != this->assignedAddresses.end(); it++) {
+		if (it->second == sensor->getAddress()) {
+			this->assignedAddresses.erase(it);
+			break;
+		}
+	}
+	if (sensor->getAddress() != VL53L1X::DEFAULT_DEVICE_ADDRESS) {
+		this->freeAddresses.insert(sensor->getAddress());
+	}
+}
+
+std::vector<VL53L1X::SharedPtr> VL53L1XDiscovery::discover(const std::vector<GPIOPin::SharedPtr>& gpioPins) {
+	// Powering off resets the sensors to the default address
+	for (const auto& gpioPin : gpioPins) {
+		gpioPin->unset();
+		this->releaseAddress(gpioPin);
+	}
+	// Hold them in reset long enough, so that they don't keep their old addresses
+	if (!gpioPins.empty()) {
+		std::this_thread::sleep_for(VL53L1X::POWER_OFF_DURATION);
+	}
+
+	std::vector<VL53L1X::SharedPtr> sensors;
+	for (const auto& gpioPin : gpioPins) {
+		auto sensor = this->bringUp(gpioPin);
+		if (sensor) {
+			sensors.push_back(std::move(sensor));
+		}
+	}
+
+	// Initialize all the sensors at once instead of waiting for each one in turn
+	for (const auto& sensor : sensors) {
+		sensor->loadDefaultConfiguration();
+	}
+	auto deadline = std::chrono::steady_clock::now()
+		+ (this->timeout.count() ? this->timeout : VL53L1XDiscovery::INITIALIZATION_TIMEOUT);
+	std::vector<VL53L1X::SharedPtr> initialized;
+	std::vector<VL53L1X::SharedPtr> pending = sensors;
+	while (!pending.empty()) {
+		std::vector<VL53L1X::SharedPtr> stillPending;
+		for (const auto& sensor : pending) {
+			if (sensor->isDataReady()) {
+				sensor->finishInitialization();
+				initialized.push_back(sensor);
+			} else {
+				stillPending.push_back(sensor);
+			}
+		}
+		pending = std::move(stillPending);
+		if (pending.empty()) {
+			break;
+		}
+		if (std::chrono::steady_clock::now() > deadline) {
+			// Give up on the sensors which didn't finish in time
+			for (const auto& sensor : pending) {
+				this->removeSensor(sensor);
+			}
+			break;
+		}
+		std::this_thread::sleep_for(1ms);
+	}
+
+	// Keep the order of the pins
+	std::vector<VL53L1X::SharedPtr> result;
+	for (const auto& sensor : sensors) {
+		if (std::find(initialized.begin(), initialized.end(), sensor) != initialized.end()) {
+			result.push_back(sensor);
+		}
+	}
+	return result;
+}
+
+std::vector<std::vector<VL53L1X::SharedPtr>> VL53L1XDiscovery::discoverAll(
+	const std::vector<VL53L1XDiscovery::BusSetup>& buses
+) {
+	std::vector<std::future<std::vector<VL53L1X::SharedPtr>>> futures;
+	futures.reserve(buses.size());
+	for (const auto& bus : buses) {
+		futures.push_back(std::async(std::launch::async, [&bus]() {
+			return bus.discovery->discover(bus.gpioPins);
+		}));
+	}
+
+	std::vector<std::vector<VL53L1X::SharedPtr>> sensors;
+	sensors.reserve(buses.size());
+	for (auto& future : futures) {
+		sensors.push_back(future.get());
+	}
+	return sensors;
+}
+
+bool VL53L1XDiscovery::isSensorAt(uint8_t address) {
+	VL53L1X sensor(this->i2cBus, nullptr, address);
+	try {
+		return sensor.getSensorId() == VL53L1X::SENSOR_ID;
+	} catch (const std::exception&) {
+		return false;
+	}
+}
+
+bool VL53L1XDiscovery::isAddressUsed(uint8_t address) {
+	VL53L1X sensor(this->i2cBus, nullptr, address);
+	try {
+		sensor.getSensorId();
+		return true;
+	} catch (const std::exception&) {
+		return false;
+	}
+}
+
+uint8_t VL53L1XDiscovery::allocateAddress() {
+	while (!this->freeAddresses.empty()) {
+		uint8_t address = *this->freeAddresses.begin();
+		this->freeAddresses.erase(this->freeAddresses.begin());
+		// Skip (and drop from the pool) addresses taken by devices not managed by this instance
+		if (!this->isAddressUsed(address)) {
+			return address;
+		}
+	}
+	return 0;
+}
+
+void VL53L1XDiscovery::releaseAddress(const GPIOPin::SharedPtr& gpioPin) {
+	auto it = this->assignedAddresses.find(gpioPin);
+	if (it != this->assignedAddresses.end()) {
+		this->freeAddresses.insert(it->second);
+		this->assignedAddresses.erase(it);
+	}
+}
+
+VL53L1X::SharedPtr VL53L1XDiscovery::bringUp(GPIOPin::SharedPtr gpioPin) {
+	auto sensor = VL53L1X::makeShared(this->i2cBus, gpioPin, VL53L1X::DEFAULT_DEVICE_ADDRESS, this->timeout);
+	sensor->powerOn();
+	if (!this->isSensorAt(VL53L1X::DEFAULT_DEVICE_ADDRESS)) {
+		sensor->powerOff();
+		return nullptr;
+	}
+
+	uint8_t address = this->allocateAddress();
+	if (address == 0) {
+		sensor->powerOff();
+		return nullptr;
+	}
+	sensor->setAddress(address);
+	this->assignedAddresses[gpioPin] = address;
+	return sensor;
+}
@@ -0,0 +1,75 @@
+#include "VL53L1XSharedMemoryPublisher.hpp"
+
+#include <cerrno>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+VL53L1XSharedMemoryPublisher::VL53L1XSharedMemoryPublisher(std::string name, std::size_t sensorCount):
+	name(std::move(name)),
+	sensorCount(sensorCount),
+	mappingSize(VL53L1XSharedMemoryLayout::size(sensorCount)),
+	mapping(nullptr),
+	slots(nullptr) {
+	// Start from a fresh segment, so that readers of a previous one are not affected by the initialization
+	::shm_unlink(this->name.c_str());
+	int fd = ::shm_open(this->name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+	if (fd < 0) {
+		throw std::system_error(errno, std::generic_category(), "Creating shared memory " + this->name + " failed");
+	}
+	if (::ftruncate(fd, static_cast<off_t>(this->mappingSize)) != 0) {
+		int error = errno;
+		::close(fd);
+		::shm_unlink(this->name.c_str());
+		throw std::system_error(error, std::generic_category(), "Resizing shared memory " + this->name + " failed");
+	}
+	this->mapping = ::mmap(nullptr, this->mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (this->mapping == MAP_FAILED) {
+		int error = errno;
+		::shm_unlink(this->name.c_str());
+		throw std::system_error(error, std::generic_category(), "Mapping shared memory " + this->name + " failed");
+	}
+
+	auto* header = new (this->mapping) VL53L1XSharedMemoryLayout::Header();
+	header->version = VL53L1XSharedMemoryLayout::VERSION;
+	header->sensorCount = static_cast<uint32_t>(sensorCount);
+	this->slots = reinterpret_cast<VL53L1XSharedMemoryLayout::Slot*>(header + 1);
+	for (std::size_t i = 0; i < sensorCount; i++) {
+		new (&this->slots[i]) VL53L1XSharedMemoryLayout::Slot();
+	}
+	// Publish the magic last, readers check it before using the segment
+	header->magic.store(VL53L1XSharedMemoryLayout::MAGIC, std::memory_order_release);
+}
+
+VL53L1XSharedMemoryPublisher::~VL53L1XSharedMemoryPublisher() {
+	::munmap(this->mapping, this->mappingSize);
+	::shm_unlink(this->name.c_str());
+}
+
+void VL53L1XSharedMemoryPublisher::publish(std::size_t index, const VL53L1X::Sample& sample, uint32_t configurationEpoch) {
+	if (index >= this->sensorCount) {
+		throw std::out_of_range("Sensor index out of range");
+	}
+	VL53L1XSharedMemoryLayout::Slot& slot = this->slots[index];
+
+	// Sequence lock: odd while writing
+	uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+	slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	slot.sampleCount.store(slot.sampleCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	slot.configurationEpoch.store(configurationEpoch, std::memory_order_relaxed);
+	slot.distance.store(sample.distance, std::memory_order_relaxed);
+	slot.timestampNs.store(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(sample.timestamp.time_since_epoch()).count(),
+		std::memory_order_relaxed
+	);
+
+	slot.sequence.store(sequence + 2, std::memory_order_release);
+}
@@ -0,0 +1,126 @@
+#include "VL53L1XSupervisor.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+VL53L1XSupervisor::VL53L1XSupervisor(
+	uint8_t faultThreshold,
+	std::chrono::milliseconds sampleTimeout,
+	std::chrono::milliseconds recoveryTimeout
+):
+	faultThreshold(std::max<uint8_t>(faultThreshold, 1)),
+	sampleTimeout(sampleTimeout),
+	recoveryTimeout(recoveryTimeout) {}
+
+std::size_t VL53L1XSupervisor::addSensor(VL53L1X::SharedPtr sensor) {
+	SupervisedSensor entry;
+	entry.sensor = std::move(sensor);
+	entry.lastSampleTime = Clock::now();
+	this->sensors.push_back(std::move(entry));
+	return this->sensors.size() - 1;
+}
+
+void VL53L1XSupervisor::poll() {
+	for (auto& entry : this->sensors) {
+		auto now = Clock::now();
+		try {
+			this->step(entry, now);
+		} catch (const std::exception&) {
+			this->handleFault(entry, now);
+		}
+	}
+}
+
+uint16_t VL53L1XSupervisor::getDistance(std::size_t index) const {
+	const auto& entry = this->sensors.at(index);
+	if (entry.state != State::HEALTHY) {
+		return 65535;
+	}
+	return entry.distance;
+}
+
+bool VL53L1XSupervisor::isHealthy(std::size_t index) const {
+	return this->sensors.at(index).state == State::HEALTHY;
+}
+
+VL53L1XSupervisor::RecoveryMetrics VL53L1XSupervisor::getRecoveryMetrics(std::size_t index) const {
+	return this->sensors.at(index).metrics;
+}
+
+void VL53L1XSupervisor::step(SupervisedSensor& entry, Clock::time_point now) {
+	switch (entry.state) {
+		case State::HEALTHY: {
+			// Never blocks: a sample that isn't ready yet is picked up on a later step
+			VL53L1X::Sample sample = {};
+			if (entry.sensor->tryGetSample(sample)) {
+				entry.distance = sample.distance;
+				entry.lastSampleTime = now;
+				entry.consecutiveFaults = 0;
+			} else if (now - entry.lastSampleTime > this->sampleTimeout) {
+				// Restart the timeout window, so that consecutive timeouts are counted separately
+				entry.lastSampleTime = now;
+				this->handleFault(entry, now);
+			}
+			break;
+		}
+
+		case State::FAULTED:
+			entry.sensor->powerOff();
+			entry.state = State::POWERED_OFF;
+			entry.stateEntryTime = now;
+			break;
+
+		case State::POWERED_OFF:
+			if (now - entry.stateEntryTime < VL53L1X::POWER_OFF_DURATION) {
+				break;
+			}
+			entry.sensor->powerOn();
+			entry.sensor->restoreAddress();
+			entry.sensor->loadDefaultConfiguration();
+			entry.state = State::INITIALIZING;
+			entry.stateEntryTime = now;
+			break;
+
+		case State::INITIALIZING:
+			if (entry.sensor->isDataReady()) {
+				entry.sensor->finishInitialization();
+				entry.sensor->restoreConfiguration();
+				this->finishRecovery(entry, Clock::now());
+			} else if (now - entry.stateEntryTime > this->recoveryTimeout) {
+				entry.metrics.failedAttempts++;
+				entry.state = State::FAULTED;
+			}
+			break;
+	}
+}
+
+void VL53L1XSupervisor::handleFault(SupervisedSensor& entry, Clock::time_point now) {
+	if (entry.state != State::HEALTHY) {
+		// Recovery attempt failed - start over with another power cycle
+		entry.metrics.failedAttempts++;
+		entry.state = State::FAULTED;
+		return;
+	}
+
+	entry.metrics.faults++;
+	entry.consecutiveFaults++;
+	if (entry.consecutiveFaults >= this->faultThreshold) {
+		entry.state = State::FAULTED;
+		entry.recoveryStartTime = now;
+	}
+}
+
+void VL53L1XSupervisor::finishRecovery(SupervisedSensor& entry, Clock::time_point now) {
+	auto latency = std::chrono::duration_cast<std::chrono::microseconds>(now - entry.recoveryStartTime);
+
+	entry.state = State::HEALTHY;
+	entry.consecutiveFaults = 0;
+	entry.distance = 65535;
+	entry.lastSampleTime = now;
+
+	entry.metrics.recoveries++;
+	entry.metrics.lastLatency = latency;
+	entry.metrics.maxLatency = std::max(entry.metrics.maxLatency, latency);
+	entry.metrics.totalLatency += latency;
+}